@@ -0,0 +1,90 @@
+#pragma once
+#include <cstdint>
+#include <cmath>
+
+// xoshiro128+ generator: 16 bytes of state and a handful of shifts per draw.
+// Plenty for visual randomness, and seedable so effects can be replayed.
+class FastRandom {
+public:
+    using result_type = std::uint32_t;
+
+    explicit FastRandom(std::uint64_t seed = 0x853C49E6748FEA9Bull) { setSeed(seed); }
+
+    // Expands a 64-bit seed into the full state with splitmix64
+    void setSeed(std::uint64_t seed) {
+        for (int i = 0; i < 4; i += 2) {
+            seed += 0x9E3779B97F4A7C15ull;
+            std::uint64_t z = seed;
+            z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+            z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+            z ^= z >> 31;
+            _state[i] = static_cast<std::uint32_t>(z);
+            _state[i + 1] = static_cast<std::uint32_t>(z >> 32);
+        }
+    }
+
+    std::uint32_t next() {
+        const std::uint32_t result = _state[0] + _state[3];
+        const std::uint32_t t = _state[1] << 9;
+
+        _state[2] ^= _state[0];
+        _state[3] ^= _state[1];
+        _state[1] ^= _state[2];
+        _state[0] ^= _state[3];
+        _state[2] ^= t;
+        _state[3] = (_state[3] << 11) | (_state[3] >> 21);
+
+        return result;
+    }
+
+    // Uniform in [0, 1), built from the 24 high bits (the low bits of xoshiro+ are weak)
+    float nextFloat() {
+        return static_cast<float>(next() >> 8) * (1.0f / 16777216.0f);
+    }
+
+    float range(float min, float max) {
+        return min + (max - min) * nextFloat();
+    }
+
+    // Uniform in [0, bound) without a division (Lemire's multiply-shift)
+    std::uint32_t below(std::uint32_t bound) {
+        return static_cast<std::uint32_t>((static_cast<std::uint64_t>(next()) * bound) >> 32);
+    }
+
+    // std::uniform_random_bit_generator interface, for std::shuffle and friends
+    static constexpr result_type min() { return 0; }
+    static constexpr result_type max() { return 0xFFFFFFFFu; }
+    result_type operator()() { return next(); }
+
+private:
+    std::uint32_t _state[4];
+};
+
+// Table-driven sine/cosine. Angles are in turns (1.0 = 360 degrees) so the
+// table index is a multiply and a mask; good to ~0.35 degrees, which is far
+// below what a moving particle can show.
+class SinCosTable {
+public:
+    static const std::uint32_t kSize = 1024;
+    static const std::uint32_t kMask = kSize - 1;
+
+    static const SinCosTable& instance() {
+        static const SinCosTable table;
+        return table;
+    }
+
+    void sinCos(float turns, float& s, float& c) const {
+        std::uint32_t index = static_cast<std::uint32_t>(static_cast<std::int32_t>(turns * kSize)) & kMask;
+        s = _sin[index];
+        c = _sin[(index + kSize / 4) & kMask];
+    }
+
+private:
+    SinCosTable() {
+        for (std::uint32_t i = 0; i < kSize; ++i) {
+            _sin[i] = static_cast<float>(std::sin(i * (2.0 * 3.14159265358979323846 / kSize)));
+        }
+    }
+
+    float _sin[kSize];
+};
@@ -0,0 +1,28 @@
+#pragma once
+#include "FontRegistry.hpp"
+#include <string>
+#include <vector>
+
+// Ordered font fallback, e.g. Roboto then a CJK font. An sf::Text draws with
+// a single font, so the fallback is per string: the first font that has
+// every glyph of it wins. CJK fonts carry Latin too, so mixed strings
+// simply switch to the CJK face as a whole.
+class FontChain {
+public:
+    // Fonts that failed to load are skipped
+    void add(FontHandle font);
+
+    bool empty() const { return _fonts.empty(); }
+    const FontHandle& primary() const;
+
+    // text is UTF-8
+    const FontHandle& select(const std::string& text) const;
+    const FontHandle& select(const sf::String& text) const;
+
+    // Rasterizes every glyph of text into the atlas page of the font that
+    // select() will pick, so the first real draw finds them all cached
+    void prewarm(const std::string& text, unsigned int characterSize, bool bold = false) const;
+
+private:
+    std::vector<FontHandle> _fonts;
+};
@@ -0,0 +1,56 @@
+#pragma once
+#include <SFML/Graphics.hpp>
+#include <cstddef>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <string>
+#include <vector>
+
+using FontHandle = std::shared_ptr<const sf::Font>;
+
+// Process-wide font cache. Every file is read and opened once; whoever asks
+// for the same path gets the same sf::Font, so FreeType faces and glyph page
+// textures are shared instead of copied per text object. A font stays
+// loaded while any handle to it is alive (and until releaseUnused()).
+class FontRegistry {
+public:
+    struct FontUsage {
+        std::string path;
+        long handles;               // Live handles, the registry's own excluded
+        std::size_t sourceBytes;    // Font file kept in memory for FreeType
+        std::size_t textureBytes;   // Glyph pages of every character size noted so far
+        std::vector<unsigned int> characterSizes;
+    };
+
+    static FontRegistry& instance();
+
+    // Loads on first use. A file that fails to load yields an empty font,
+    // like a failed sf::Font::loadFromFile, and is retried next time.
+    // Different fonts can be loaded from several threads at once.
+    FontHandle acquire(const std::string& path);
+
+    // Records that font is drawn at size, so report() can count that glyph page
+    void noteCharacterSize(const sf::Font& font, unsigned int size);
+
+    // Drops fonts nobody holds a handle to anymore
+    void releaseUnused();
+
+    std::vector<FontUsage> report() const;
+    std::size_t getMemoryUsage() const;
+
+private:
+    FontRegistry() = default;
+
+    struct Entry {
+        std::shared_ptr<sf::Font> font;
+        std::vector<char> source;   // loadFromMemory needs it alive as long as the font
+        std::set<unsigned int> characterSizes;
+    };
+
+    FontUsage describe(const std::string& path, const Entry& entry) const;
+
+    mutable std::mutex _mutex;
+    std::map<std::string, Entry> _fonts;
+};
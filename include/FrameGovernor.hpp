@@ -0,0 +1,40 @@
+#pragma once
+#include <cstddef>
+
+// Watches how long frames take and turns that into a quality scale in
+// [minScale, 1] for optional work such as particles. Frame times are
+// smoothed, and the scale only moves after the average has stayed out of
+// the dead band for a while, so it does not flicker around the budget.
+class FrameGovernor {
+public:
+    // targetFrameTime: the budget in seconds, e.g. 1/60
+    explicit FrameGovernor(float targetFrameTime = 1.0f / 60.0f);
+
+    void setTargetFrameTime(float seconds) { _target = seconds; }
+    float getTargetFrameTime() const { return _target; }
+    void setMinScale(float scale) { _minScale = scale; }
+    // For chaining governors: a held direction never moves the scale and
+    // starts judging from scratch once released
+    void setMayShrink(bool may) { _mayShrink = may; }
+    void setMayGrow(bool may) { _mayGrow = may; }
+
+    // Feed the time the frame spent working (excluding vsync/limiter sleep).
+    // Returns true when the scale changed.
+    bool addFrame(float seconds);
+
+    float getScale() const { return _scale; }
+    bool isAtMin() const { return _scale <= _minScale; }
+    bool isAtMax() const { return _scale >= 1.0f; }
+    float getAverageFrameTime() const { return _average; }
+
+private:
+    float _target;
+    float _minScale;
+    float _scale;
+    float _average;       // Exponential moving average of frame times
+    int _overFrames;      // Consecutive frames above the band
+    int _underFrames;     // Consecutive frames below the band
+    int _cooldown;        // Frames to wait after a change before judging again
+    bool _mayShrink;
+    bool _mayGrow;
+};
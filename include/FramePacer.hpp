@@ -0,0 +1,61 @@
+#pragma once
+#include <SFML/System.hpp>
+
+// Decides how often the game loop updates and draws. While something moves
+// quickly (input just happened, bursts, fades) frames run at the full rate.
+// Once only slow glows and drifting particles are left it drops to a low
+// rate, and after a long stretch without input it sleeps: no frames at
+// all until the next window event.
+//
+// The pacer also replaces the window's framerate limit, so the time spent
+// in display() can be measured as part of the frame instead of hiding the
+// limiter's sleep.
+class FramePacer {
+public:
+    enum class Mode {
+        Active,   // Full rate
+        Idle,     // Low rate, only slow animation left
+        Sleep     // Long without input; frames only while something still fades out
+    };
+
+    FramePacer();
+
+    void setActiveRate(float framesPerSecond);
+    void setIdleRate(float framesPerSecond);
+    // How long full rate is kept after the last activity
+    void setActiveHold(float seconds) { _activeHold = sf::seconds(seconds); }
+    // How long without activity before going to sleep (0 = never)
+    void setSleepAfter(float seconds) { _sleepAfter = sf::seconds(seconds); }
+
+    // Input or a new effect: back to full rate. Coming out of Idle or Sleep
+    // the next frame is due at once; when already active it keeps its slot
+    void wake();
+
+    // Whether the loop should update and draw now
+    bool isFrameDue() const;
+    // How long the loop may sleep before checking again
+    sf::Time getWaitTime() const;
+
+    // Call when a due frame starts; the next one is due an interval later
+    void frameStarted();
+
+    // Call after each frame. busy: something animated fast this frame
+    // (a fade, a typewriter, a burst), which counts as activity
+    void frameDone(bool busy);
+
+    Mode getMode() const { return _mode; }
+    bool isSleeping() const { return _mode == Mode::Sleep; }
+
+private:
+    sf::Time frameInterval() const;
+
+    sf::Clock _clock;
+    sf::Time _lastFrame;
+    sf::Time _lastActivity;
+    sf::Time _activeInterval;
+    sf::Time _idleInterval;
+    sf::Time _activeHold;
+    sf::Time _sleepAfter;
+    Mode _mode;
+    bool _forceFrame;
+};
@@ -0,0 +1,96 @@
+#pragma once
+#include <SFML/Graphics.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// Glyph metrics of one character size and style of a baked font: the same
+// numbers sf::Font would give, but read from a file instead of FreeType.
+// Texture rects point into the GlyphAtlas texture.
+class BakedFace {
+public:
+    BakedFace(unsigned int characterSize, bool bold, float lineSpacing);
+
+    unsigned int getCharacterSize() const { return _characterSize; }
+    bool isBold() const { return _bold; }
+    float getLineSpacing() const { return _lineSpacing; }
+
+    // nullptr when the character was not baked
+    const sf::Glyph* findGlyph(sf::Uint32 codePoint) const;
+    // An empty glyph for characters that were not baked, like sf::Font
+    const sf::Glyph& getGlyph(sf::Uint32 codePoint) const;
+    float getKerning(sf::Uint32 first, sf::Uint32 second) const;
+
+    // True when every character of text can be drawn from this face
+    bool covers(const sf::String& text) const;
+
+    // Used by the baker
+    void addGlyph(sf::Uint32 codePoint, const sf::Glyph& glyph);
+    void addKerning(sf::Uint32 first, sf::Uint32 second, float amount);
+    const std::unordered_map<sf::Uint32, sf::Glyph>& getGlyphs() const { return _glyphs; }
+    const std::unordered_map<std::uint64_t, float>& getKerningPairs() const { return _kerning; }
+
+private:
+    unsigned int _characterSize;
+    bool _bold;
+    float _lineSpacing;
+    std::unordered_map<sf::Uint32, sf::Glyph> _glyphs;
+    std::unordered_map<std::uint64_t, float> _kerning;  // Non-zero pairs only, (first << 32) | second
+};
+
+// Prebuilt glyph atlas made at build time by the FontBaker tool: one image
+// holding every baked size and style of a font, plus a metrics file. Text
+// drawn from it never goes through FreeType, so there is nothing to
+// rasterize on first draw. Text with characters outside the atlas falls
+// back to sf::Font.
+//
+// The metrics file is plain text, one record per line:
+//   atlas <version> <faceCount> <font family>
+//   face <size> <bold 0|1> <lineSpacing> <glyphCount> <kerningCount>
+//   g <codePoint> <advance> <left> <top> <width> <height> <texLeft> <texTop> <texWidth> <texHeight>
+//   k <first> <second> <amount>
+// with the glyph and kerning records of a face following its face line.
+class GlyphAtlas {
+public:
+    static const int kVersion = 1;
+
+    GlyphAtlas();
+
+    // Atlas shared by the UI
+    static GlyphAtlas& instance();
+
+    // Returns false (and stays empty) if either file is missing or malformed
+    bool loadFromFile(const std::string& imagePath, const std::string& metricsPath);
+    // Same with the image already decoded, e.g. by a worker thread; only
+    // the texture upload is left
+    bool loadFromImage(const sf::Image& image, const std::string& metricsPath);
+    bool saveMetrics(const std::string& metricsPath) const;
+
+    bool isLoaded() const { return !_faces.empty() && _texture.getSize().x > 0; }
+    // Whether the atlas was baked from this font (family name match)
+    bool isBakedFrom(const sf::Font& font) const;
+
+    const BakedFace* findFace(unsigned int characterSize, bool bold) const;
+    const sf::Texture& getTexture() const { return _texture; }
+    std::size_t getMemoryUsage() const;
+
+    // Used by the baker
+    void setFamily(const std::string& family) { _family = family; }
+    void addFace(BakedFace face);
+    const std::vector<BakedFace>& getFaces() const { return _faces; }
+
+    // Appends two triangles per visible character of text to vertices,
+    // positioned the way sf::Text would (first baseline at the character
+    // size, '\n' starts a line). Returns the bounds of what was appended.
+    static sf::FloatRect appendText(const BakedFace& face, const sf::String& text, float lineSpacing,
+                                    const sf::Color& color, sf::VertexArray& vertices);
+
+private:
+    bool loadMetrics(const std::string& metricsPath);
+
+    std::string _family;
+    std::vector<BakedFace> _faces;
+    sf::Texture _texture;
+};
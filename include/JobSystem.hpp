@@ -0,0 +1,122 @@
+#pragma once
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Work-stealing thread pool shared by the whole game.
+// Every worker has its own job queue: it pushes and pops at the back, so
+// the jobs it just spawned stay hot in its cache, and when it runs dry it
+// steals from the front of another queue. Threads outside the pool (the
+// main thread) share one more queue. A thread waiting for jobs to finish
+// runs queued jobs meanwhile, so jobs may wait on jobs of their own.
+//
+// Jobs are a function pointer, a context pointer and an index, never a
+// std::function, so submitting allocates nothing once the queues are warm.
+class JobSystem {
+public:
+    using JobFunction = void (*)(const void* context, std::size_t index);
+    using Counter = std::atomic<std::size_t>;
+
+    // What one thread did since the previous sampleStats()
+    struct WorkerStats {
+        std::uint64_t jobs;
+        std::uint64_t steals;       // Jobs taken from another thread's queue
+        double busySeconds;
+        double utilization;         // busySeconds over the sampled interval (0-1)
+    };
+
+    // 0 = one worker per hardware thread, minus the caller
+    explicit JobSystem(unsigned int workerCount = 0);
+    ~JobSystem();
+
+    JobSystem(const JobSystem&) = delete;
+    JobSystem& operator=(const JobSystem&) = delete;
+
+    unsigned int getWorkerCount() const { return static_cast<unsigned int>(_threads.size()); }
+
+    // Queues function(context, index) for index in [first, first + count).
+    // pending is decremented once per finished job; the caller adds count
+    // to it beforehand and keeps context alive until it reaches zero.
+    void submit(JobFunction function, const void* context, std::size_t first, std::size_t count, Counter& pending);
+    // Runs queued jobs until pending reaches zero; blocks while there are none
+    void wait(const Counter& pending);
+
+    // Runs task(0) .. task(taskCount - 1) and returns once all of them finished.
+    // Templated so the callable is passed by pointer, never copied into a std::function.
+    template <typename Task>
+    void parallelFor(std::size_t taskCount, const Task& task) {
+        if (taskCount == 0) return;
+        // Not worth queuing a single task, or anything without workers
+        if (_threads.empty() || taskCount == 1) {
+            for (std::size_t i = 0; i < taskCount; ++i) {
+                task(i);
+            }
+            return;
+        }
+        Counter pending(taskCount);
+        submit(&JobSystem::invoke<Task>, &task, 0, taskCount, pending);
+        wait(pending);
+    }
+
+    // Entry 0 is the threads outside the pool, 1.. the workers. Resets the counters.
+    std::vector<WorkerStats> sampleStats();
+
+private:
+    struct Job {
+        JobFunction function;
+        const void* context;
+        std::size_t index;
+        Counter* pending;
+    };
+
+    // Ring buffer of jobs; grows (rarely) when full
+    struct alignas(64) Queue {
+        std::mutex mutex;
+        std::vector<Job> jobs;
+        std::size_t head = 0;   // Oldest job, where thieves take
+        std::size_t size = 0;
+
+        void push(const Job& job);
+        bool popBack(Job& job);
+        bool popFront(Job& job);
+    };
+
+    struct alignas(64) Counters {
+        std::atomic<std::uint64_t> jobs{0};
+        std::atomic<std::uint64_t> steals{0};
+        std::atomic<std::uint64_t> busyNanoseconds{0};
+    };
+
+    template <typename Task>
+    static void invoke(const void* context, std::size_t index) {
+        (*static_cast<const Task*>(context))(index);
+    }
+
+    // Queue of the calling thread: its own for workers, the shared one otherwise
+    std::size_t currentSlot() const;
+    bool findJob(std::size_t slot, Job& job);
+    void execute(std::size_t slot, const Job& job);
+    void workerLoop(std::size_t slot);
+
+    std::vector<std::thread> _threads;
+    std::unique_ptr<Queue[]> _queues;
+    std::unique_ptr<Counters[]> _counters;
+    std::size_t _slotCount;
+
+    // Sleeping workers; _queued counts jobs sitting in any queue
+    std::mutex _sleepMutex;
+    std::condition_variable _wake;
+    std::atomic<std::size_t> _queued;
+    // Threads blocked in wait(), woken when a counter reaches zero or jobs arrive
+    std::condition_variable _progress;
+    unsigned int _waiting;              // Guarded by _sleepMutex
+    bool _stopping;
+
+    std::chrono::steady_clock::time_point _lastSample;
+};
@@ -0,0 +1,131 @@
+#pragma once
+#include <SFML/Graphics.hpp>
+
+// Where particles of one emission appear
+enum class EmitterShape {
+    Point,  // All at the emit position
+    Area,   // Uniformly inside position + [0, areaWidth) x [0, areaHeight)
+    Ring    // On a circle of the given radius around the emit position
+};
+
+// Where particle colors come from
+enum class EmitterColorMode {
+    Fixed,   // colorStart
+    Tint,    // RGB passed to emit(), alpha from colorStart
+    Random   // Random RGB in [100, 255], alpha from colorStart
+};
+
+// sf::Color has no constexpr constructors in SFML 2, so descriptors keep their own
+struct EmitterColor {
+    sf::Uint8 r, g, b, a;
+
+    sf::Color toColor() const { return sf::Color(r, g, b, a); }
+};
+
+// A particle effect declared as data. Every range is sampled uniformly per
+// particle and a range with min == max is a constant. Angles are in degrees.
+//
+// Descriptors are literal types built with chained constexpr setters, so an
+// effect table can live in a header and be handed to
+// ParticleSystem::emit<Descriptor>(), which folds every choice below into a
+// specialized emit kernel at compile time.
+struct EmitterDescriptor {
+    EmitterShape shape = EmitterShape::Point;
+    float areaWidth = 0.0f;
+    float areaHeight = 0.0f;
+    float radius = 0.0f;
+
+    float minSpeed = 0.0f;
+    float maxSpeed = 0.0f;
+    float minAngle = 0.0f;
+    float maxAngle = 360.0f;
+    bool evenAngles = false;      // Spread directions evenly instead of randomly
+
+    float minLifetime = 1.0f;
+    float maxLifetime = 1.0f;
+    float fadeEase = 0.0f;        // Alpha curve: 0 = linear fade, 1 = quadratic (fades early)
+
+    float minSize = 1.0f;
+    float maxSize = 1.0f;
+    float minRotation = 0.0f;
+    float maxRotation = 0.0f;
+    float minRotationSpeed = 0.0f;
+    float maxRotationSpeed = 0.0f;
+    bool alternateSpin = false;   // Every other particle spins the opposite way
+
+    float gravity = 50.0f;        // Downward acceleration in px/s^2
+    float fieldResponse = 0.0f;   // How strongly force fields and neighbors push (0 = ignore them)
+
+    EmitterColorMode colorMode = EmitterColorMode::Fixed;
+    EmitterColor colorStart = {255, 255, 255, 255};
+    EmitterColor colorEnd = {255, 255, 255, 255};
+    bool colorRamp = false;       // Blend toward colorEnd over the lifetime
+
+    bool trail = false;           // Leave a tapering motion trail
+
+    constexpr EmitterDescriptor point() const { EmitterDescriptor d = *this; d.shape = EmitterShape::Point; return d; }
+    constexpr EmitterDescriptor area(float width, float height) const {
+        EmitterDescriptor d = *this; d.shape = EmitterShape::Area; d.areaWidth = width; d.areaHeight = height; return d;
+    }
+    constexpr EmitterDescriptor ring(float r) const { EmitterDescriptor d = *this; d.shape = EmitterShape::Ring; d.radius = r; return d; }
+    constexpr EmitterDescriptor speed(float min, float max) const { EmitterDescriptor d = *this; d.minSpeed = min; d.maxSpeed = max; return d; }
+    constexpr EmitterDescriptor angles(float min, float max, bool even = false) const {
+        EmitterDescriptor d = *this; d.minAngle = min; d.maxAngle = max; d.evenAngles = even; return d;
+    }
+    constexpr EmitterDescriptor lifetime(float min, float max, float ease = 0.0f) const {
+        EmitterDescriptor d = *this; d.minLifetime = min; d.maxLifetime = max; d.fadeEase = ease; return d;
+    }
+    constexpr EmitterDescriptor size(float min, float max) const { EmitterDescriptor d = *this; d.minSize = min; d.maxSize = max; return d; }
+    constexpr EmitterDescriptor rotation(float min, float max) const { EmitterDescriptor d = *this; d.minRotation = min; d.maxRotation = max; return d; }
+    constexpr EmitterDescriptor spin(float min, float max, bool alternate = false) const {
+        EmitterDescriptor d = *this; d.minRotationSpeed = min; d.maxRotationSpeed = max; d.alternateSpin = alternate; return d;
+    }
+    constexpr EmitterDescriptor withGravity(float g) const { EmitterDescriptor d = *this; d.gravity = g; return d; }
+    constexpr EmitterDescriptor respondToFields(float response) const { EmitterDescriptor d = *this; d.fieldResponse = response; return d; }
+    constexpr EmitterDescriptor color(EmitterColor c, EmitterColorMode mode = EmitterColorMode::Fixed) const {
+        EmitterDescriptor d = *this; d.colorStart = c; d.colorEnd = c; d.colorMode = mode; return d;
+    }
+    constexpr EmitterDescriptor fadeTo(EmitterColor c) const { EmitterDescriptor d = *this; d.colorEnd = c; d.colorRamp = true; return d; }
+    constexpr EmitterDescriptor withTrail() const { EmitterDescriptor d = *this; d.trail = true; return d; }
+};
+
+// Built-in effects used by the game
+namespace Emitters {
+    // Purple-ish memory fragments bursting outward
+    inline constexpr EmitterDescriptor MemoryLoss = EmitterDescriptor()
+        .speed(25.0f, 90.0f)
+        .lifetime(1.5f, 2.3f)
+        .size(3.0f, 7.0f)
+        .rotation(0.0f, 360.0f)
+        .spin(100.0f, 400.0f, true)
+        .respondToFields(1.0f)
+        .withTrail()
+        .color({150, 100, 200, 200});
+
+    // Small burst in the color of the chosen option
+    inline constexpr EmitterDescriptor Choice = EmitterDescriptor()
+        .speed(40.0f, 80.0f)
+        .lifetime(1.0f, 1.0f)
+        .size(2.0f, 5.0f)
+        .rotation(0.0f, 360.0f)
+        .spin(200.0f, 200.0f, true)
+        .color({255, 255, 255, 180}, EmitterColorMode::Tint);
+
+    // Subtle ambient particles drifting up from anywhere on screen
+    inline constexpr EmitterDescriptor Floating = EmitterDescriptor()
+        .area(1200.0f, 800.0f)
+        .speed(10.0f, 30.0f)
+        .angles(270.0f, 270.0f)
+        .lifetime(3.0f, 8.0f)
+        .size(1.0f, 2.0f)
+        .color({255, 255, 255, 70}, EmitterColorMode::Random);
+
+    // Eight evenly spaced sparks
+    inline constexpr EmitterDescriptor Sparkle = EmitterDescriptor()
+        .speed(100.0f, 100.0f)
+        .angles(0.0f, 360.0f, true)
+        .lifetime(0.5f, 0.5f)
+        .size(4.0f, 4.0f)
+        .spin(500.0f, 500.0f)
+        .color({255, 255, 255, 255}, EmitterColorMode::Tint);
+}
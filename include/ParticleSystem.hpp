@@ -1,8 +1,14 @@
 #pragma once
 #include <SFML/Graphics.hpp>
 #include <vector>
-#include <random>
 #include <cmath>
+#include <cstdint>
+#include <memory>
+#include "AlignedAllocator.hpp"
+#include "FastMath.hpp"
+#include "JobSystem.hpp"
+#include "ParticleEmitter.hpp"
+#include "SpatialHash.hpp"
 
 struct Particle {
     sf::Vector2f position;
@@ -15,32 +21,387 @@ struct Particle {
     float rotationSpeed;
 };
 
+// Area of influence that pushes particles around. Only particles emitted
+// with a non-zero EmitterDescriptor::fieldResponse feel it.
+struct ForceField {
+    enum class Type {
+        Attractor,  // Pulls toward the center
+        Repulsor,   // Pushes away from the center
+        Vortex      // Swirls around the center
+    };
+
+    Type type;
+    sf::Vector2f position;
+    float strength;  // Acceleration at the center in px/s^2, fading to zero at radius
+    float radius;
+};
+
+// Structure-of-arrays particle storage.
+// Every field lives in its own contiguous array so the update kernel can
+// stream through it with SIMD loads instead of striding over fat structs.
+// The arrays are sized once to a fixed capacity; live particles occupy
+// [0, live) and dead ones are removed by swapping in the last live slot.
+// Arrays start on a cache line so update chunks never share one.
+struct ParticleStorage {
+    template <typename T>
+    using Array = std::vector<T, AlignedAllocator<T, 64>>;
+
+    Array<float> posX;
+    Array<float> posY;
+    Array<float> prevX;         // Position before the last update, for interpolated drawing
+    Array<float> prevY;
+    Array<float> velX;
+    Array<float> velY;
+    Array<float> rotation;
+    Array<float> rotationSpeed;
+    Array<float> lifetime;
+    Array<float> maxLifetime;
+    Array<float> size;
+    Array<float> gravity;
+    Array<float> fade;          // Alpha curve blend, see EmitterDescriptor::fadeEase
+    Array<float> response;      // Force field response, see EmitterDescriptor::fieldResponse
+    Array<sf::Color> color;
+    Array<sf::Color> colorEnd;
+    Array<std::int32_t> trail;  // Slot in the trail slab, -1 = no trail
+    std::size_t live = 0;
+
+    std::size_t count() const { return live; }
+    std::size_t capacity() const { return lifetime.size(); }
+    bool empty() const { return live == 0; }
+    bool full() const { return live == capacity(); }
+
+    // Resizes every array; particles past the new capacity are dropped
+    void setCapacity(std::size_t capacity);
+    void write(std::size_t index, const Particle& p);
+    void copy(std::size_t from, std::size_t to);
+    void clear() { live = 0; }
+
+    // O(1) removal: the last live particle takes the freed slot
+    void remove(std::size_t index);
+
+    // Swap-removes dead particles inside [begin, end) only, without touching
+    // anything outside it. Survivors end up in [begin, begin + result).
+    // Trail slots of removed particles are appended to releasedTrails.
+    std::size_t compactRange(std::size_t begin, std::size_t end,
+                             std::int32_t* releasedTrails, std::size_t& releasedCount);
+    // Moves count particles starting at from down to to (to <= from)
+    void moveRange(std::size_t from, std::size_t to, std::size_t count);
+};
+
+// Vertices of one frame of particles. buildBatch() fills it from the
+// simulation and drawBatch() submits it, so the two can run on different
+// threads. The arrays keep their capacity from frame to frame.
+struct ParticleBatch {
+    sf::VertexArray quads{sf::Triangles};
+    sf::VertexArray points{sf::Points};
+    sf::VertexArray trails{sf::Triangles};
+    std::size_t quadCount = 0;
+    std::size_t pointCount = 0;
+    std::size_t trailSegmentCount = 0;
+};
+
 class ParticleSystem {
 public:
-    ParticleSystem();
-    
+    // What emission does once every slot of the pool is taken
+    enum class OverflowPolicy {
+        DropNew,                  // Discard the new particles
+        RecycleOldest,            // Overwrite the particles that have lived longest
+        RecycleShortestRemaining  // Overwrite the particles closest to dying
+    };
+
+    static const std::size_t kDefaultCapacity = 4096;
+
+    // Update work unit: a whole number of 64-byte cache lines per array
+    static const std::size_t kChunkSize = 2048;
+    static const std::size_t kDefaultParallelThreshold = 32768;
+
+    // Motion trails: past positions per trail, and how many trails may exist at once
+    static const std::size_t kTrailLength = 8;
+    static const std::size_t kDefaultTrailCapacity = 1024;
+
+    explicit ParticleSystem(std::size_t capacity = kDefaultCapacity);
+
     // Create particle effects
     void createMemoryLossEffect(const sf::Vector2f& position, int count = 30);
     void createChoiceEffect(const sf::Vector2f& position, const sf::Color& color, int count = 20);
     void createFloatingParticles(int count = 15);
     void createSparkle(const sf::Vector2f& position, const sf::Color& color);
-    
-    // Update and render
+
+    // Emits up to count particles described by a compile-time descriptor.
+    // Every descriptor decision is resolved while compiling, so the generated
+    // kernel only contains the loops that effect actually needs.
+    // Returns how many particles were emitted.
+    template <const EmitterDescriptor& Descriptor>
+    std::size_t emit(const sf::Vector2f& position, int count, const sf::Color& tint = sf::Color::White);
+
+    // Same as emit<>() for descriptors built at runtime
+    std::size_t emitBatch(const EmitterDescriptor& descriptor, const sf::Vector2f& position, int count,
+                          const sf::Color& tint = sf::Color::White);
+
+    // Reseed the emission generator so effects can be reproduced
+    void setSeed(std::uint64_t seed) { _random.setSeed(seed); }
+
+    // Update and render. interpolation (0-1) places the drawn particles between
+    // their positions before and after the last update, so a fixed-step
+    // simulation still moves smoothly at any display rate
     void update(float deltaTime);
-    void draw(sf::RenderWindow& window);
-    
+    void draw(sf::RenderTarget& target, float interpolation = 1.0f);
+
+    // draw() in two halves. buildBatch() reads the particles and must not
+    // overlap update(); drawBatch() only touches the batch and the circle
+    // texture, so it can run on the render thread while the next update runs
+    void buildBatch(ParticleBatch& batch, float interpolation = 1.0f);
+    void drawBatch(sf::RenderTarget& target, const ParticleBatch& batch);
+
     // Clear all particles
     void clear();
-    
+
     // Check if system is active
     bool isEmpty() const { return _particles.empty(); }
+    std::size_t getParticleCount() const { return _particles.count(); }
+
+    // Pool budget (allocates only here, never during emission)
+    void setCapacity(std::size_t capacity);
+    std::size_t getCapacity() const { return _particles.capacity(); }
+    void setOverflowPolicy(OverflowPolicy policy) { _overflowPolicy = policy; }
+    OverflowPolicy getOverflowPolicy() const { return _overflowPolicy; }
+
+    // Load shedding, usually driven by a FrameGovernor: every emission is
+    // scaled by this factor (0-1] and the live cap becomes capacity * scale.
+    // Particles already above a lowered cap are left to die naturally.
+    void setBudgetScale(float scale);
+    float getBudgetScale() const { return _budgetScale; }
+
+    // Live count at which update() fans chunks out to the job system.
+    // Both paths run the same chunk kernel, so their output is identical.
+    void setParallelThreshold(std::size_t threshold) { _parallelThreshold = threshold; }
+    std::size_t getParallelThreshold() const { return _parallelThreshold; }
+    // Shares the game's job system instead of starting workers of its own
+    void setJobSystem(JobSystem* jobs);
+    // Size of the system's own workers, without setJobSystem().
+    // 0 = one worker per hardware thread (the default)
+    void setWorkerCount(unsigned int workerCount);
+
+    // Visible area. update() kills particles that leave it by more than
+    // margin pixels; draw() skips anything outside it.
+    void setViewBounds(const sf::FloatRect& bounds, float margin = 64.0f);
+    const sf::FloatRect& getViewBounds() const { return _viewBounds; }
+
+    // Level of detail in draw(): particles fainter than dropAlpha (0-1) are
+    // skipped, and ones whose radius * alpha is below pointCoverage pixels
+    // are drawn as single points instead of textured quads
+    void setLodThresholds(float dropAlpha, float pointCoverage);
+
+    // Force fields, re-declared by the game whenever its layout changes
+    void addForceField(const ForceField& field);
+    void clearForceFields() { _fieldTerms.clear(); }
+
+    // Trail budget. All trails share one preallocated slab; particles
+    // emitted while it is exhausted simply get no trail.
+    void setTrailCapacity(std::size_t capacity);
+
+    // Soft particle-particle repulsion among field-responsive particles.
+    // Neighbors come from a spatial hash rebuilt every update, so the cost
+    // stays near O(n). strength 0 turns it off.
+    void setInteraction(float radius, float strength);
+
+    // What the last draw() or buildBatch() produced
+    std::size_t getDrawnQuadCount() const { return _drawnQuads; }
+    std::size_t getDrawnPointCount() const { return _drawnPoints; }
+    std::size_t getDrawnTrailSegmentCount() const { return _drawnTrailSegments; }
 
 private:
-    std::vector<Particle> _particles;
-    std::mt19937 _rng;
-    
-    // Helper functions
-    sf::Color randomColor(float alpha = 255.0f);
-    sf::Vector2f randomVelocity(float speed);
+    ParticleStorage _particles;
+    OverflowPolicy _overflowPolicy;
+    float _budgetScale;
+    FastRandom _random;
+
+    // Preallocated scratch for emission: granted slot indices and recycle candidates
+    std::vector<std::uint32_t> _emitSlots;
+    std::vector<std::uint32_t> _victims;
+
+    // Parallel update: survivors per chunk. Without a shared job system
+    // one of its own is created on first use
+    std::vector<std::size_t> _chunkLive;
+    std::vector<std::size_t> _chunkReleasedTrails;
+    std::size_t _parallelThreshold;
+    unsigned int _workerCount;
+    JobSystem* _jobs;
+    std::unique_ptr<JobSystem> _ownJobs;
+
+    // Batched rendering: visible particles become textured quads in one
+    // vertex array, low-detail ones go into a second array of points.
+    // _batch is what draw() uses; threaded callers bring their own
+    ParticleBatch _batch;
+    sf::Texture _circleTexture;
+    bool _circleTextureReady;
+    std::size_t _drawnQuads;
+    std::size_t _drawnPoints;
+
+    // Trail slab: kTrailLength ring-buffered positions per trail slot
+    std::vector<sf::Vector2f> _trailPoints;
+    std::vector<std::uint8_t> _trailHead;
+    std::vector<std::uint8_t> _trailCount;
+    std::vector<std::int32_t> _freeTrails;      // Stack of unused trail slots
+    std::vector<std::int32_t> _releasedTrails;  // Per-chunk scratch written during update
+    std::size_t _drawnTrailSegments;
+
+    // Force fields, stored pre-folded so one branch-free formula handles all
+    // three types: a = falloff * (radial * d + tangential * perp(d))
+    struct FieldTerm {
+        sf::Vector2f position;
+        float radiusSq;
+        float inverseRadius;
+        float strength;
+        float radial;
+        float tangential;
+    };
+    std::vector<FieldTerm> _fieldTerms;
+
+    // Particle-particle interaction
+    SpatialHashGrid _grid;
+    bool _gridDirty;
+    float _interactionRadius;
+    float _interactionStrength;
+
+    // Culling and LOD
+    sf::FloatRect _viewBounds;
+    float _cullMargin;
+    float _lodDropAlpha;
+    float _lodPointCoverage;
+
+    // Reserves up to count slots (evicting per the overflow policy when full).
+    // The granted indices are in _emitSlots; returns how many were granted.
+    std::size_t acquireSlots(std::size_t count);
+
+    // Emission building blocks; each fills one field of the n granted slots
+    template <typename T>
+    void fillConstant(ParticleStorage::Array<T>& field, std::size_t n, const T& value);
+    template <bool Constant>
+    void fillUniform(ParticleStorage::Array<float>& field, std::size_t n, float min, float max);
+    template <bool EvenAngles, bool ConstantSpeed>
+    void fillVelocity(std::size_t n, float minAngle, float maxAngle, float minSpeed, float maxSpeed);
+    void fillPositions(EmitterShape shape, std::size_t n, const sf::Vector2f& position,
+                       float width, float height, float radius);
+    void fillLifetime(std::size_t n, float min, float max);
+    void fillRandomColor(std::size_t n, sf::Uint8 alpha);
+    void fillTrails(std::size_t n);
+
+    void releaseTrail(std::size_t index);
+    void resetTrails();
+    // Pushes the current positions in [begin, end) into their trail ring buffers
+    void recordTrails(std::size_t begin, std::size_t end);
+    // Appends one tapering ribbon for a trail slot to the batch's trails
+    void appendTrail(ParticleBatch& batch, std::int32_t slot, float width, const sf::Color& color);
+    template <bool Alternate>
+    void fillSpin(std::size_t n, float min, float max);
+
+    // Rasterizes the anti-aliased circle sprite shared by all particle quads
+    void createCircleTexture();
+
+    // Integrates [begin, end) of the storage: position, rotation, lifetime and gravity drift
+    static void integrate(ParticleStorage& storage, std::size_t begin, std::size_t end, float deltaTime);
+    // Adds field and neighbor accelerations to the velocities in [begin, end).
+    // Reads positions of any particle, writes only its own range.
+    void applyForces(std::size_t begin, std::size_t end, float deltaTime);
+    // Zeroes the lifetime of particles in [begin, end) outside the given rectangle
+    static void cull(ParticleStorage& storage, std::size_t begin, std::size_t end, const sf::FloatRect& keep);
 };
 
+template <typename T>
+void ParticleSystem::fillConstant(ParticleStorage::Array<T>& field, std::size_t n, const T& value) {
+    const std::uint32_t* slots = _emitSlots.data();
+    for (std::size_t i = 0; i < n; ++i) {
+        field[slots[i]] = value;
+    }
+}
+
+template <bool Constant>
+void ParticleSystem::fillUniform(ParticleStorage::Array<float>& field, std::size_t n, float min, float max) {
+    if (Constant) {
+        fillConstant(field, n, min);
+        return;
+    }
+
+    const std::uint32_t* slots = _emitSlots.data();
+    for (std::size_t i = 0; i < n; ++i) {
+        field[slots[i]] = _random.range(min, max);
+    }
+}
+
+template <bool EvenAngles, bool ConstantSpeed>
+void ParticleSystem::fillVelocity(std::size_t n, float minAngle, float maxAngle, float minSpeed, float maxSpeed) {
+    // Direction from the sin/cos table, speed from the range
+    const std::uint32_t* slots = _emitSlots.data();
+    const SinCosTable& table = SinCosTable::instance();
+    const float minTurns = minAngle / 360.0f;
+    const float spanTurns = (maxAngle - minAngle) / 360.0f;
+    const float evenStep = spanTurns / static_cast<float>(n);
+
+    for (std::size_t i = 0; i < n; ++i) {
+        float turns = minTurns + (EvenAngles ? evenStep * i : spanTurns * _random.nextFloat());
+        float speed = ConstantSpeed ? minSpeed : _random.range(minSpeed, maxSpeed);
+        float s, c;
+        table.sinCos(turns, s, c);
+        _particles.velX[slots[i]] = c * speed;
+        _particles.velY[slots[i]] = s * speed;
+    }
+}
+
+template <bool Alternate>
+void ParticleSystem::fillSpin(std::size_t n, float min, float max) {
+    const std::uint32_t* slots = _emitSlots.data();
+    for (std::size_t i = 0; i < n; ++i) {
+        float spin = _random.range(min, max);
+        _particles.rotationSpeed[slots[i]] = (Alternate && (i & 1)) ? -spin : spin;
+    }
+}
+
+template <const EmitterDescriptor& D>
+std::size_t ParticleSystem::emit(const sf::Vector2f& position, int count, const sf::Color& tint) {
+    const std::size_t n = acquireSlots(static_cast<std::size_t>(count > 0 ? count : 0));
+    if (n == 0) return 0;
+
+    fillPositions(D.shape, n, position, D.areaWidth, D.areaHeight, D.radius);
+    fillVelocity<D.evenAngles, D.minSpeed == D.maxSpeed>(n, D.minAngle, D.maxAngle, D.minSpeed, D.maxSpeed);
+    fillLifetime(n, D.minLifetime, D.maxLifetime);
+    fillUniform<D.minSize == D.maxSize>(_particles.size, n, D.minSize, D.maxSize);
+    fillUniform<D.minRotation == D.maxRotation>(_particles.rotation, n, D.minRotation, D.maxRotation);
+
+    if constexpr (D.alternateSpin) {
+        fillSpin<true>(n, D.minRotationSpeed, D.maxRotationSpeed);
+    } else {
+        fillUniform<D.minRotationSpeed == D.maxRotationSpeed>(_particles.rotationSpeed, n, D.minRotationSpeed, D.maxRotationSpeed);
+    }
+
+    fillConstant(_particles.gravity, n, D.gravity);
+    fillConstant(_particles.fade, n, D.fadeEase);
+    fillConstant(_particles.response, n, D.fieldResponse);
+
+    if constexpr (D.trail) {
+        fillTrails(n);
+    } else {
+        fillConstant(_particles.trail, n, std::int32_t(-1));
+    }
+
+    sf::Color start = D.colorStart.toColor();
+    if constexpr (D.colorMode == EmitterColorMode::Random) {
+        fillRandomColor(n, D.colorStart.a);
+    } else {
+        if constexpr (D.colorMode == EmitterColorMode::Tint) {
+            start = sf::Color(tint.r, tint.g, tint.b, D.colorStart.a);
+        }
+        fillConstant(_particles.color, n, start);
+    }
+
+    if constexpr (D.colorRamp) {
+        fillConstant(_particles.colorEnd, n, D.colorEnd.toColor());
+    } else {
+        const std::uint32_t* slots = _emitSlots.data();
+        for (std::size_t i = 0; i < n; ++i) {
+            _particles.colorEnd[slots[i]] = _particles.color[slots[i]];
+        }
+    }
+
+    return n;
+}
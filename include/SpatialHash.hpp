@@ -0,0 +1,114 @@
+#pragma once
+#include <SFML/Graphics.hpp>
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+// Uniform grid over a bounded area, rebuilt from scratch every frame with a
+// counting sort (two linear passes, no per-cell containers). Points outside
+// the area are clamped into the border cells, so nothing is ever lost.
+// Neighbor queries visit the 3x3 block of cells around a point, which keeps
+// them O(1) per query when the cell size matches the query radius.
+class SpatialHashGrid {
+public:
+    SpatialHashGrid();
+
+    // Allocates the cell table; call when the area or cell size changes
+    void configure(const sf::FloatRect& bounds, float cellSize);
+    // Allocates room for up to count points so build() never does
+    void reserve(std::size_t count);
+
+    // Inserts every point i in [0, n) for which include(i) is true
+    template <typename Include>
+    void build(const float* x, const float* y, std::size_t n, Include include);
+
+    // Calls visit(index) for every stored point in the cells around (x, y)
+    // until visit returns false
+    template <typename Visit>
+    void forEachNear(float x, float y, Visit visit) const;
+
+    std::size_t size() const { return _entryCount; }
+
+private:
+    int cellX(float x) const;
+    int cellY(float y) const;
+
+    sf::FloatRect _bounds;
+    float _inverseCellSize;
+    int _columns;
+    int _rows;
+
+    std::vector<std::uint32_t> _cellStart;   // Cell c spans [_cellStart[c], _cellStart[c + 1])
+    std::vector<std::uint32_t> _entries;     // Point indices sorted by cell
+    std::vector<std::int32_t> _entryCell;    // Cell of each point (-1 = not inserted)
+    std::size_t _entryCount;
+};
+
+inline int SpatialHashGrid::cellX(float x) const {
+    int cx = static_cast<int>((x - _bounds.left) * _inverseCellSize);
+    return cx < 0 ? 0 : (cx >= _columns ? _columns - 1 : cx);
+}
+
+inline int SpatialHashGrid::cellY(float y) const {
+    int cy = static_cast<int>((y - _bounds.top) * _inverseCellSize);
+    return cy < 0 ? 0 : (cy >= _rows ? _rows - 1 : cy);
+}
+
+template <typename Include>
+void SpatialHashGrid::build(const float* x, const float* y, std::size_t n, Include include) {
+    if (_entryCell.size() < n) {
+        reserve(n);
+    }
+
+    // Pass 1: count points per cell (cell c counts into slot c + 1)
+    std::fill(_cellStart.begin(), _cellStart.end(), 0u);
+    for (std::size_t i = 0; i < n; ++i) {
+        if (!include(i)) {
+            _entryCell[i] = -1;
+            continue;
+        }
+        std::int32_t cell = cellY(y[i]) * _columns + cellX(x[i]);
+        _entryCell[i] = cell;
+        ++_cellStart[cell + 1];
+    }
+
+    // Prefix sum: slot c + 1 becomes the end of cell c
+    for (std::size_t c = 1; c < _cellStart.size(); ++c) {
+        _cellStart[c] += _cellStart[c - 1];
+    }
+    _entryCount = _cellStart.back();
+
+    // Pass 2: scatter. Slot c + 1 is cell c's write cursor: walking backwards
+    // and pre-decrementing keeps points in index order inside each cell, so
+    // queries are deterministic. Afterwards slot c + 1 holds the start of c.
+    for (std::size_t i = n; i-- > 0;) {
+        std::int32_t cell = _entryCell[i];
+        if (cell < 0) continue;
+        _entries[--_cellStart[cell + 1]] = static_cast<std::uint32_t>(i);
+    }
+
+    // Shift back so slot c is the start of cell c and slot c + 1 its end
+    const std::size_t cells = _cellStart.size() - 1;
+    for (std::size_t c = 0; c < cells; ++c) {
+        _cellStart[c] = _cellStart[c + 1];
+    }
+    _cellStart[cells] = static_cast<std::uint32_t>(_entryCount);
+}
+
+template <typename Visit>
+void SpatialHashGrid::forEachNear(float x, float y, Visit visit) const {
+    if (_entryCount == 0) return;
+
+    const int cx = cellX(x);
+    const int cy = cellY(y);
+    for (int gy = cy - 1; gy <= cy + 1; ++gy) {
+        if (gy < 0 || gy >= _rows) continue;
+        for (int gx = cx - 1; gx <= cx + 1; ++gx) {
+            if (gx < 0 || gx >= _columns) continue;
+            const int cell = gy * _columns + gx;
+            for (std::uint32_t e = _cellStart[cell]; e < _cellStart[cell + 1]; ++e) {
+                if (!visit(_entries[e])) return;
+            }
+        }
+    }
+}
@@ -4,9 +4,20 @@
 #include <map>
 #include <random>
 #include <memory>
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
 #include <SFML/Graphics.hpp>
 #include "ParticleSystem.hpp"
+#include "FrameGovernor.hpp"
+#include "FramePacer.hpp"
+#include "JobSystem.hpp"
+#include "TaskGraph.hpp"
 #include "TextEffect.hpp"
+#include "TripleBuffer.hpp"
+#include "UiChrome.hpp"
+#include "UiText.hpp"
 
 struct Memory {
     std::string description;
@@ -40,15 +51,87 @@ class StoryGame {
 public:
     StoryGame();
     void run();
+
+    // Renders the world (background and particles) at this fraction of the
+    // window size and scales it up; the UI stays at full resolution.
+    // smooth: linear filtering instead of crisp pixels. 1 = off.
+    void setRenderScale(float scale, bool smooth = false);
+    float getRenderScale() const { return _renderScale; }
+    // Lets the render scale follow frame time (on by default, linear
+    // filtering); a fixed setRenderScale() needs this off
+    void setDynamicResolution(bool enabled);
+    // Draws and presents on a second thread so a slow display() never
+    // holds up input or the simulation (on by default with 2+ cores)
+    void setThreadedRendering(bool enabled) { _threadedRendering = enabled; }
+    // Prints how busy each job system thread was, every few seconds
+    void setJobStats(bool enabled) { _showJobStats = enabled; }
+    // Prints what each loaded font costs in memory when the game starts
+    void setFontStats(bool enabled) { _showFontStats = enabled; }
     
 private:
+    // What the simulation hands to rendering each frame
+    struct FrameSnapshot {
+        ParticleBatch particles;    // Already interpolated
+        bool showConsequence = false;
+        float consequenceFade = 0.0f;  // 1 -> 0 while the consequence is shown
+        double simulatedSeconds = 0.0; // Drives the text effects on the render thread
+    };
+    // What the UI shows, copied out of the game state on the main thread
+    // whenever it changes; the render thread lays text out from this alone
+    struct UiState {
+        GameState state = GameState::WakingUp;
+        bool hasScene = false;
+        std::size_t choiceCount = 0;
+        std::string mainText;
+        std::string statsText;
+        std::string choiceTexts[9];
+        std::string consequenceText;
+        unsigned int consequenceId = 0;  // Changes every time a consequence is shown
+        std::string gameOverStats;
+    };
+    // Where rendering placed things, fed back to the force fields
+    struct UiLayout {
+        sf::FloatRect statsBox;
+        std::size_t choiceCount = 0;
+        float choiceY[9] = {};
+    };
+
     void initializeGame();
+    void prewarmGlyphs();
     void processInput();
+    void handleEvent(const sf::Event& event);
     void update();
-    void render();
+    // The frame's work as a task graph, built once
+    void buildFrameGraph();
+    // One fixed simulation step: particles and ambient emission...
+    void simulateParticles(float step);
+    // ...and the consequence timer (text effects themselves run on the render thread)
+    void simulateEffects(float step);
+    // Builds the snapshot for this frame; interpolation is how far past the last
+    // simulation step it is (0-1)
+    void publishFrame(float interpolation);
+    // Render thread: draws every new snapshot until stopped
+    void renderLoop();
+    void renderFrame(const FrameSnapshot& frame);
+    // Feeds the render time of a frame to the governors
+    void judgeFrame(float workTime);
     void displayScene();
     void displayMemoryLoss();
-    void displayStats();
+    std::string describeStats() const;
+    // Main thread: copies what the UI shows into the next UiState
+    void publishUi();
+    // Render thread: sets the UI texts from a new UiState
+    void applyUi(const UiState& ui);
+    void renderGameOver(float time);
+    // Where the background and particles go this frame, already cleared
+    sf::RenderTarget& beginWorld(const sf::Color& clearColor);
+    // Scales the off-screen world (if any) onto the window
+    void presentWorld();
+    // Moves/resizes a box; true if it actually changed
+    bool placeBox(sf::RectangleShape& box, float x, float y, float width, float height);
+    void rebuildChrome(bool showTextBox);
+    void updateChromeColors(float time);
+    void updateForceFields();
     
     // 游戏机制
     void loseMemory(int amount = 1);
@@ -59,6 +142,16 @@ private:
     // 场景生成
     Scene generateRandomScene();
     std::string generateStreetDescription();
+    // The random parts of a scene (street, choices, whether a memory turns
+    // up); returns the bare street description
+    std::string rollScene(Scene& scene);
+    // The parts that follow the game state: familiarity hints, which lost memory
+    void fitScene(Scene& scene, const std::string& street);
+    // Prepares the next scene off the input path
+    void pregenerateScene();
+    Scene takeNextScene();
+    void printJobStats();
+    void printFontStats();
     
     // 游戏状态
     GameState _state;
@@ -68,54 +161,117 @@ private:
     int _familiarity;        // 街道熟悉度
     std::vector<Memory> _memories;  // 拥有的记忆
     std::vector<Memory> _lostMemories;  // 已失去的记忆
+    // Bumped on every change, so a pregenerated scene can tell it is stale
+    unsigned int _familiarityVersion;
+    unsigned int _lostMemoriesVersion;
     
     // 肉鸽元素
     std::vector<Scene> _scenes;
     int _currentSceneIndex;
     std::mt19937 _rng;
+    Scene _nextScene;               // 预生成的下一个场景
+    std::string _nextSceneStreet;
+    bool _hasNextScene;
+    unsigned int _nextSceneFamiliarityVersion;
+    unsigned int _nextSceneLostMemoriesVersion;
     
     // 剧情文本
     std::vector<std::string> _streetDescriptions;
     std::vector<std::string> _memoryLossTexts;
     std::vector<std::string> _familiarityTexts;
+    std::vector<std::string> _eventTexts;
+    std::vector<std::pair<std::string, std::string>> _choiceTemplates;  // 选项文字与后果
     
     bool _gameRunning;
     
     // SFML 窗口和渲染
     sf::RenderWindow _window;
-    sf::Font _font;
-    sf::Text _titleText;
-    sf::Text _mainText;
-    sf::Text _statsText;
-    sf::Text _choiceTexts[9];  // 最多9个选择
-    sf::Text _inputText;
-    sf::Text _consequenceText;
+    FontHandle _font;
+    FontChain _fonts;        // Roboto，缺字时回退到中文字体
+    UiText _titleText;
+    UiText _mainText;
+    UiText _statsText;
+    UiText _choiceTexts[9];  // 最多9个选择
+    UiText _inputText;
+    UiText _gameOverTitle;
+    UiText _gameOverStats;
+    UiText _exitPrompt;
+    bool _uiDirty;           // 游戏状态变化后重新发布 UiState
+    std::string _consequenceString;
     std::string _currentInput;
     int _selectedChoice;
     bool _waitingForInput;
     bool _showConsequence;
     float _consequenceTimer;
+    float _simulationTime;   // Elapsed time not yet simulated, under one step after each frame
+    double _simulatedSeconds; // Simulated so far, in whole steps
+    unsigned int _consequenceId;
     
     // 背景
-    sf::RectangleShape _background;
     sf::Color _bgColor;
     
+    // Job system shared by the frame graph and the particle update
+    JobSystem _jobs;
+    TaskGraph _frameGraph;
+    int _frameSteps;                    // Simulation steps due this frame
+    bool _showJobStats;
+    bool _showFontStats;
+    sf::Clock _jobStatsClock;
+
     // Visual effects
     ParticleSystem _particleSystem;
-    sf::Clock _ambientParticleTimer;
+    float _ambientParticleTimer;        // Simulated seconds since the last ambient burst
     float _ambientParticleInterval;
+    FastRandom _ambientRandom;          // Only the particle node draws from it
     bool _gameOverParticlesCreated;
+    FrameGovernor _frameGovernor;       // Sheds particles when frames run over budget
+    FramePacer _framePacer;             // Drops the frame rate while the player is just reading
+    std::atomic<float> _particleBudget; // _frameGovernor's scale, judged on the render thread
+
+    // Render thread. Frames, UI states and layouts pass through lock-free
+    // triple buffers; the render thread never reads the game state itself
+    bool _threadedRendering;
+    std::thread _renderThread;
+    bool _renderRunning;                // Guarded by _frameMutex
+    std::mutex _frameMutex;
+    std::condition_variable _frameReady;
+    TripleBuffer<FrameSnapshot> _frames;
+    TripleBuffer<UiState> _uiStates;
+    TripleBuffer<UiLayout> _layouts;
+    // What the UI was last built for; the game state may already be ahead
+    GameState _shownState;
+    bool _shownScene;
+    std::size_t _shownChoices;
+    unsigned int _shownConsequenceId;
+    double _effectSeconds;              // Simulated time the text effects have reached
     
-    // UI elements
+    // UI elements. The boxes only hold layout and colors; they are drawn
+    // through _chrome
+    enum ChromeGroup {
+        ChromeTitleFill, ChromeTitleOutline,
+        ChromeStatsFill, ChromeStatsOutline,
+        ChromeTextFill, ChromeTextOutline, ChromeTextGlow,
+        ChromeEndStatsFill, ChromeEndStatsOutline, ChromeCorners
+    };
+    UiChrome _chrome;
+    GameState _chromeState;         // State the chrome geometry was built for
+    bool _chromeShowsTextBox;
     sf::RectangleShape _titleBox;
     sf::RectangleShape _statsBox;
     sf::RectangleShape _textBox;
     sf::RectangleShape _choiceBoxes[9];
     
-    // Pixel art effect
+    // Pixel art effect / low internal resolution. The texture is allocated
+    // at full size once; smaller scales only use its top-left part
     sf::RenderTexture _pixelRenderTexture;
     sf::Sprite _pixelSprite;
+    sf::RectangleShape _pixelClear;     // Fills just that part in place of a full clear()
+    bool _pixelClearAll;                // Scale changed: clear the whole texture once
     bool _usePixelEffect;
+    float _renderScale;
+    bool _renderSmooth;
+    bool _dynamicResolution;
+    FrameGovernor _resolutionGovernor;  // Lowers the render scale when frames run over budget
     
     // Text effects
     TextEffect _mainTextEffect;
@@ -0,0 +1,44 @@
+#pragma once
+#include "JobSystem.hpp"
+#include <atomic>
+#include <cstddef>
+#include <functional>
+#include <string>
+#include <vector>
+
+// Work of a frame as a small dependency graph. Built once, then run() as
+// often as needed: every node becomes a job as soon as the nodes it depends
+// on finished, so independent work spreads over the JobSystem's workers.
+// Nodes may themselves use parallelFor on the same JobSystem.
+class TaskGraph {
+public:
+    using NodeId = std::size_t;
+
+    NodeId add(const std::string& name, std::function<void()> work);
+    // after only starts once before finished
+    void precede(NodeId before, NodeId after);
+
+    // Runs every node once and returns when all of them finished
+    void run(JobSystem& jobs);
+
+    std::size_t getNodeCount() const { return _nodes.size(); }
+    const std::string& getName(NodeId node) const { return _nodes[node].name; }
+    // How long the node took in the last run()
+    double getLastSeconds(NodeId node) const { return _nodes[node].lastSeconds; }
+
+private:
+    struct Node {
+        std::string name;
+        std::function<void()> work;
+        std::vector<NodeId> successors;
+        unsigned int dependencies = 0;
+        double lastSeconds = 0.0;
+    };
+
+    static void runNode(const void* context, std::size_t node);
+
+    std::vector<Node> _nodes;
+    std::vector<std::atomic<unsigned int>> _remaining;  // Unfinished dependencies, per run
+    JobSystem* _jobs = nullptr;                        // Set while running
+    JobSystem::Counter _pending{0};
+};
@@ -1,5 +1,8 @@
 #pragma once
 #include <SFML/Graphics.hpp>
+#include "FastMath.hpp"
+#include "FontChain.hpp"
+#include "GlyphAtlas.hpp"
 #include <string>
 #include <vector>
 
@@ -11,69 +14,212 @@ public:
         FadeIn,          // 淡入效果
         Glow,            // 发光效果
         Shake,           // 震动效果
-        Wave             // 波浪效果
+        Wave,            // 波浪效果
+        Dissolve         // 记忆消散效果
     };
-    
+
+    // Effect passes for setChain<>(). Each pass adds its share to the
+    // per-glyph parameters of the frame; apply() returns true once a finite
+    // effect has finished (continuous ones always do). start() puts the
+    // pass back to its initial state.
+    struct Typewriter;
+    struct FadeIn;
+    struct Glow;
+    struct Shake;
+    struct Wave;
+    struct Dissolve;
+
     TextEffect();
-    
-    // Set text and effect
+
+    // Set text (UTF-8) and effect. The enum picks the matching one-pass chain.
     void setText(const std::string& text, EffectType type = EffectType::Typewriter);
-    void setFont(const sf::Font& font);
+    // New text (UTF-8) for the current chain; call start() to play it
+    void setString(const std::string& text);
+    // The font is shared, not copied; get it from FontRegistry
+    void setFont(FontHandle font);
+    // Fallback chain; the font is picked per text at layout time
+    void setFonts(const FontChain& fonts);
     void setCharacterSize(unsigned int size);
     void setFillColor(const sf::Color& color);
     void setPosition(const sf::Vector2f& position);
-    
+    // Word-wraps to this width in pixels (0 = no wrapping), like UiText
+    void setWrapWidth(float width);
+
+    // Runs several passes together, e.g. setChain<Typewriter, Glow, Shake>().
+    // The combination is compiled into one update function, so a frame costs
+    // one indirect call rather than a switch or virtual call per effect.
+    // Keeps the current text; call start() to play it.
+    template <typename... Effects>
+    void setChain();
+
     // Update and render
     void update(float deltaTime);
     void draw(sf::RenderWindow& window);
-    
+
     // Control
     void start();
     void reset();
     bool isComplete() const;
-    
+
     // Settings
     void setTypewriterSpeed(float charsPerSecond);
     void setFadeSpeed(float fadeSpeed);
     void setGlowIntensity(float intensity);
     void setShakeIntensity(float intensity);
-    
+
     // Get current displayed text
     std::string getCurrentText() const;
     sf::FloatRect getGlobalBounds() const;
     sf::Color getFillColor() const;
 
 private:
+    using ChainUpdate = bool (*)(TextEffect&, float);
+    using ChainStart = void (*)(TextEffect&);
+
+    template <typename... Effects>
+    static bool runChain(TextEffect& effect, float deltaTime);
+    template <typename... Effects>
+    static void startChain(TextEffect& effect);
+
     std::string _fullText;
-    std::string _displayText;
-    EffectType _effectType;
-    
+
     // Text properties
-    sf::Text _text;
-    sf::Font _font;
+    FontChain _fonts;
+    FontHandle _font;        // Picked from _fonts for the current text
+    unsigned int _characterSize;
+    float _wrapWidth;
     sf::Color _baseColor;  // Base color to avoid accumulation
-    
+
+    // Glyph quads of the full text, laid out once per text/font/size change.
+    // The typewriter draws a prefix of it instead of re-laying out a growing string.
+    sf::VertexArray _glyphs;
+    std::vector<std::size_t> _glyphVertexEnd;  // Vertex count covering chars [0, i)
+    const BakedFace* _bakedFace;                // Set when _glyphs index the GlyphAtlas texture
+    bool _layoutDirty;
+
+    // Current chain
+    ChainUpdate _chainUpdate;
+    ChainStart _chainStart;
+    bool _animatesGlyphs;    // False when the chain only reveals (draws _glyphs as is)
+
     // Animation state
     float _timer;
-    int _currentCharIndex;
+    int _currentCharIndex;   // Characters drawn; the typewriter moves it
+    float _revealProgress;   // Characters revealed so far, fractional
+    float _fadeAlpha;        // Whole-text alpha, 0-1
+    float _brightness;       // Whole-text color multiplier
     bool _isActive;
     bool _isComplete;
-    
+
     // Effect parameters
     float _typewriterSpeed;  // characters per second
     float _fadeSpeed;
     float _glowIntensity;
     float _shakeIntensity;
-    
-    // Shake effect
+
     sf::Vector2f _basePosition;
-    sf::Vector2f _shakeOffset;
-    
+
+    // Per-glyph animation. Passes only write these parameter arrays; one
+    // pass then transforms every glyph quad of _glyphs into _animated,
+    // which is drawn with a single call.
+    std::vector<float> _glyphCenterX;
+    std::vector<float> _glyphCenterY;
+    std::vector<float> _glyphSeed;       // Stable per-glyph random in [0, 1)
+    std::vector<float> _glyphOffsetX;
+    std::vector<float> _glyphOffsetY;
+    std::vector<float> _glyphAngle;      // In turns, see SinCosTable
+    std::vector<float> _glyphAlpha;      // 0-1, multiplies the base alpha
+    std::vector<sf::Vertex> _animated;
+    FastRandom _random;
+
     // Helper functions
-    void updateTypewriter(float deltaTime);
-    void updateFadeIn(float deltaTime);
+    void buildLayout();
+    template <typename Glyphs>
+    void layoutGlyphs(const sf::String& text, const Glyphs& glyphs);
+    void drawGlyphs(sf::RenderWindow& window, const sf::Vertex* vertices, std::size_t vertexCount);
+    void restart();
+    void beginGlyphFrame();
+    void applyGlyphTransforms();
+    bool updateTypewriter(float deltaTime);
+    bool updateFadeIn(float deltaTime);
     void updateGlow(float deltaTime);
     void updateShake(float deltaTime);
     void updateWave(float deltaTime);
+    bool updateDissolve(float deltaTime);
 };
 
+struct TextEffect::Typewriter {
+    static const bool kFinite = true;
+    static const bool kAnimatesGlyphs = false;
+    static void start(TextEffect& e) { e._revealProgress = 0.0f; e._currentCharIndex = 0; }
+    static bool apply(TextEffect& e, float dt) { return e.updateTypewriter(dt); }
+};
+
+struct TextEffect::FadeIn {
+    static const bool kFinite = true;
+    static const bool kAnimatesGlyphs = true;
+    static void start(TextEffect& e) { e._fadeAlpha = 0.0f; }
+    static bool apply(TextEffect& e, float dt) { return e.updateFadeIn(dt); }
+};
+
+struct TextEffect::Glow {
+    static const bool kFinite = false;
+    static const bool kAnimatesGlyphs = true;
+    static void start(TextEffect&) {}
+    static bool apply(TextEffect& e, float dt) { e.updateGlow(dt); return true; }
+};
+
+struct TextEffect::Shake {
+    static const bool kFinite = false;
+    static const bool kAnimatesGlyphs = true;
+    static void start(TextEffect&) {}
+    static bool apply(TextEffect& e, float dt) { e.updateShake(dt); return true; }
+};
+
+struct TextEffect::Wave {
+    static const bool kFinite = false;
+    static const bool kAnimatesGlyphs = true;
+    static void start(TextEffect&) {}
+    static bool apply(TextEffect& e, float dt) { e.updateWave(dt); return true; }
+};
+
+struct TextEffect::Dissolve {
+    static const bool kFinite = true;
+    static const bool kAnimatesGlyphs = true;
+    static void start(TextEffect&) {}
+    static bool apply(TextEffect& e, float dt) { return e.updateDissolve(dt); }
+};
+
+template <typename... Effects>
+void TextEffect::setChain() {
+    _chainUpdate = &TextEffect::runChain<Effects...>;
+    _chainStart = &TextEffect::startChain<Effects...>;
+    _animatesGlyphs = (false || ... || Effects::kAnimatesGlyphs);
+    restart();
+}
+
+template <typename... Effects>
+void TextEffect::startChain([[maybe_unused]] TextEffect& effect) {
+    (Effects::start(effect), ...);
+}
+
+template <typename... Effects>
+bool TextEffect::runChain(TextEffect& effect, [[maybe_unused]] float deltaTime) {
+    // Continuous passes never hold up completion, but a chain made only of
+    // them runs forever; the empty chain (EffectType::None) is done at once
+    constexpr bool hasEnd = sizeof...(Effects) == 0 || (false || ... || Effects::kFinite);
+    constexpr bool animates = (false || ... || Effects::kAnimatesGlyphs);
+
+    if (animates) {
+        effect.beginGlyphFrame();
+    }
+
+    // Every pass runs, in order; done stays true only if all of them are
+    bool done = true;
+    ((done = Effects::apply(effect, deltaTime) && done), ...);
+
+    if (animates) {
+        effect.applyGlyphTransforms();
+    }
+    return hasEnd && done;
+}
@@ -0,0 +1,78 @@
+#pragma once
+#include <SFML/Graphics.hpp>
+#include "GlyphAtlas.hpp"
+#include <cstddef>
+#include <list>
+#include <string>
+#include <unordered_map>
+
+// A string broken into lines for a given width, with its line metrics
+struct WrappedText {
+    sf::String text;          // Original text with '\n' at every line break
+    std::size_t lineCount;
+    float width;              // Widest line
+    float height;             // lineCount * line spacing
+};
+
+// Greedy word wrapping with sf::Text's advance and kerning rules. Lines
+// break at spaces, between CJK characters, or inside a word that is wider
+// than the whole line. Results are kept in a bounded LRU keyed by
+// (string, font, size, width, spacing, bold), so re-wrapping a string that
+// was seen recently is a hash lookup.
+class TextLayoutCache {
+public:
+    static const std::size_t kDefaultCapacity = 256;
+
+    explicit TextLayoutCache(std::size_t capacity = kDefaultCapacity);
+
+    // Shared cache for the UI
+    static TextLayoutCache& instance();
+
+    // text is UTF-8
+    const WrappedText& wrap(const std::string& text, const sf::Font& font, unsigned int characterSize,
+                            float maxWidth, float lineSpacing = 1.0f, bool bold = false);
+    // Same, measured with baked metrics (no FreeType)
+    const WrappedText& wrap(const std::string& text, const BakedFace& face,
+                            float maxWidth, float lineSpacing = 1.0f);
+
+    void setCapacity(std::size_t capacity);
+    std::size_t size() const { return _entries.size(); }
+    std::size_t getHitCount() const { return _hits; }
+    std::size_t getMissCount() const { return _misses; }
+
+    static WrappedText layout(const sf::String& text, const sf::Font& font, unsigned int characterSize,
+                              float maxWidth, float lineSpacing, bool bold);
+    static WrappedText layout(const sf::String& text, const BakedFace& face, float maxWidth, float lineSpacing);
+
+private:
+    struct Key {
+        std::string text;
+        const void* font;     // sf::Font or BakedFace
+        unsigned int characterSize;
+        float maxWidth;
+        float lineSpacing;
+        bool bold;
+
+        bool operator==(const Key& other) const {
+            return font == other.font && characterSize == other.characterSize &&
+                   maxWidth == other.maxWidth && lineSpacing == other.lineSpacing &&
+                   bold == other.bold && text == other.text;
+        }
+    };
+
+    struct KeyHash {
+        std::size_t operator()(const Key& key) const;
+    };
+
+    using Entry = std::pair<Key, WrappedText>;
+
+    template <typename Layout>
+    const WrappedText& find(Key key, const Layout& build);
+    void trim();
+
+    std::size_t _capacity;
+    std::list<Entry> _entries;  // Most recently used first
+    std::unordered_map<Key, std::list<Entry>::iterator, KeyHash> _index;
+    std::size_t _hits;
+    std::size_t _misses;
+};
@@ -0,0 +1,43 @@
+#pragma once
+#include <atomic>
+#include <cstdint>
+
+// Lock-free hand-over of whole values from one writer thread to one reader
+// thread. Of the three slots the writer owns one (back), the reader owns one
+// (front) and the third sits in the middle. publish() swaps back and middle,
+// take() swaps middle and front if a newer value is waiting. Neither side
+// ever blocks, and the reader always sees a complete value: the newest one,
+// or the one it had before. Slots are reused, so the writer should only
+// overwrite what changed.
+template <typename T>
+class TripleBuffer {
+public:
+    TripleBuffer() : _back(0), _middle(1), _front(2) {}
+
+    TripleBuffer(const TripleBuffer&) = delete;
+    TripleBuffer& operator=(const TripleBuffer&) = delete;
+
+    // Writer: fill back(), then publish() it
+    T& back() { return _slots[_back]; }
+    void publish() {
+        _back = _middle.exchange(static_cast<std::uint8_t>(_back | kFresh), std::memory_order_acq_rel) & kIndex;
+    }
+
+    // Reader: take() the newest value if there is one, then read front()
+    bool hasFresh() const { return (_middle.load(std::memory_order_acquire) & kFresh) != 0; }
+    bool take() {
+        if (!hasFresh()) return false;
+        _front = _middle.exchange(_front, std::memory_order_acq_rel) & kIndex;
+        return true;
+    }
+    const T& front() const { return _slots[_front]; }
+
+private:
+    static const std::uint8_t kIndex = 0x3;
+    static const std::uint8_t kFresh = 0x4;  // Middle holds a value the reader has not taken
+
+    T _slots[3];
+    std::uint8_t _back;
+    std::atomic<std::uint8_t> _middle;
+    std::uint8_t _front;
+};
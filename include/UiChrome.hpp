@@ -0,0 +1,49 @@
+#pragma once
+#include <SFML/Graphics.hpp>
+#include <cstddef>
+#include <vector>
+
+// Retained geometry for the static UI: every box, outline and corner piece
+// of a screen lives in one vertex buffer, drawn with a single call. The
+// geometry is only rebuilt (clear/add/commit) when the layout changes.
+//
+// Each rectangle belongs to a color group. Colors are not baked into the
+// vertices: a small shader reads the group color from a uniform array, so
+// glow and pulse animations only update a few uniforms per frame. Without
+// shader support the colors are written into the vertices instead.
+class UiChrome : public sf::Drawable {
+public:
+    static const std::size_t kMaxGroups = 16;
+
+    UiChrome();
+
+    void setGroupColor(std::size_t group, const sf::Color& color);
+    const sf::Color& getGroupColor(std::size_t group) const { return _colors[group]; }
+
+    // Geometry, between clear() and commit()
+    void clear();
+    void addRect(const sf::FloatRect& rect, std::size_t group);
+    // Band of the given thickness just outside rect
+    void addFrame(const sf::FloatRect& rect, float thickness, std::size_t group);
+    // Fill and outline of an unrotated shape, as sf::RectangleShape draws them
+    void addShape(const sf::RectangleShape& shape, std::size_t fillGroup, std::size_t outlineGroup);
+    void commit();
+
+    std::size_t getVertexCount() const { return _vertices.size(); }
+    // How many times the geometry was uploaded, for checking layouts stay put
+    std::size_t getRebuildCount() const { return _rebuildCount; }
+
+private:
+    void draw(sf::RenderTarget& target, sf::RenderStates states) const override;
+    // Pushes changed group colors to the shader uniforms or the vertices
+    void applyColors() const;
+
+    mutable std::vector<sf::Vertex> _vertices;  // texCoords.x holds the group
+    std::vector<sf::Color> _colors;
+    mutable sf::VertexBuffer _buffer;
+    mutable sf::Shader _shader;
+    bool _useShader;
+    bool _useBuffer;
+    mutable bool _colorsDirty;
+    std::size_t _rebuildCount;
+};
@@ -0,0 +1,67 @@
+#pragma once
+#include <SFML/Graphics.hpp>
+#include "FontChain.hpp"
+#include "GlyphAtlas.hpp"
+#include <cstddef>
+#include <string>
+
+// Retained text widget. Content, style and position are only pushed into
+// the underlying sf::Text when they actually change, so its glyph geometry
+// is rebuilt on content changes rather than every frame, and the bounds are
+// cached alongside. Colors are the exception: setFillColor only recolors the
+// existing vertices, which keeps per-frame glow and pulse effects cheap.
+//
+// Strings the loaded GlyphAtlas covers are drawn from it as one vertex
+// array; anything else (CJK, italic, sizes that were not baked) goes
+// through sf::Text and the font chain.
+class UiText : public sf::Drawable {
+public:
+    UiText();
+
+    void setFont(const sf::Font& font);
+    // Picks the font from the chain for every new string (the chain must outlive this)
+    void setFonts(const FontChain& fonts);
+    void setCharacterSize(unsigned int size);
+    void setLineSpacing(float spacing);
+    void setStyle(sf::Uint32 style);
+    void setPosition(float x, float y);
+    void setFillColor(const sf::Color& color);
+    // Word-wraps to this width in pixels (0 = no wrapping). Wrapped layouts
+    // come from the shared TextLayoutCache.
+    void setWrapWidth(float width);
+
+    // text is UTF-8. Returns true when the content changed and the layout
+    // will be rebuilt
+    bool setString(const std::string& text);
+    const std::string& getString() const { return _content; }
+
+    const sf::Vector2f& getPosition() const { return _text.getPosition(); }
+    const sf::FloatRect& getLocalBounds() const;
+    sf::FloatRect getGlobalBounds() const;
+    // Line count * line spacing, known as soon as the string is set
+    float getTextHeight() const { return _textHeight; }
+    std::size_t getLineCount() const { return _lineCount; }
+
+    // How many times the layout was invalidated, for checking idle frames stay idle
+    std::size_t getLayoutCount() const { return _layoutCount; }
+
+private:
+    void draw(sf::RenderTarget& target, sf::RenderStates states) const override;
+    void invalidate();
+    // Re-picks the font, re-wraps and hands the result to _text
+    void relayout();
+    const BakedFace* findBakedFace(const sf::String& text) const;
+
+    sf::Text _text;
+    sf::VertexArray _atlasVertices;
+    sf::FloatRect _atlasBounds;
+    const BakedFace* _face;  // Face _atlasVertices come from, nullptr when drawing _text
+    const FontChain* _fonts;
+    std::string _content;
+    float _wrapWidth;
+    float _textHeight;
+    std::size_t _lineCount;
+    mutable sf::FloatRect _bounds;
+    mutable bool _boundsDirty;
+    std::size_t _layoutCount;
+};
@@ -0,0 +1,45 @@
+#pragma once
+#include <SFML/Graphics.hpp>
+#include <cstddef>
+#include <string>
+
+// All game text is UTF-8 in std::string; these convert at the SFML boundary
+// and edit strings by code point rather than by byte.
+namespace Utf8Text {
+    inline sf::String decode(const std::string& text) {
+        return sf::String::fromUtf8(text.begin(), text.end());
+    }
+
+    inline void append(std::string& text, sf::Uint32 codePoint) {
+        sf::Utf8::encode(codePoint, std::back_inserter(text));
+    }
+
+    // Removes the last code point (a lead byte plus its continuation bytes)
+    inline void popBack(std::string& text) {
+        while (!text.empty()) {
+            unsigned char byte = static_cast<unsigned char>(text.back());
+            text.pop_back();
+            if ((byte & 0xC0) != 0x80) break;
+        }
+    }
+
+    // Byte length of the first count code points
+    inline std::size_t prefixBytes(const std::string& text, std::size_t count) {
+        std::size_t bytes = 0;
+        while (bytes < text.size() && count > 0) {
+            ++bytes;
+            while (bytes < text.size() && (static_cast<unsigned char>(text[bytes]) & 0xC0) == 0x80) {
+                ++bytes;
+            }
+            --count;
+        }
+        return bytes;
+    }
+
+    inline bool isAscii(const std::string& text) {
+        for (char c : text) {
+            if (static_cast<unsigned char>(c) >= 0x80) return false;
+        }
+        return true;
+    }
+}
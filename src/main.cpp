@@ -1,7 +1,49 @@
 #include "StoryGame.hpp"
+#include <cstdlib>
+#include <string>
+
+#if defined(__linux__)
+#include <X11/Xlib.h>
+#endif
+
+int main(int argc, char** argv) {
+#if defined(__linux__)
+    // The render thread talks to X11 while this one polls events
+    XInitThreads();
+#endif
 
-int main() {
     StoryGame game;
+
+    // The world resolution adapts to frame time by default.
+    // --render-scale 0.5 fixes it at half resolution instead (cheaper on
+    // software renderers); --render-smooth filters that upscale instead of
+    // keeping hard pixels. --no-dynamic-resolution keeps full resolution.
+    // --single-thread draws on the main thread instead of a render thread.
+    // --job-stats prints how busy the job system's threads are,
+    // --font-stats what the loaded fonts cost in memory.
+    float renderScale = 1.0f;
+    bool renderSmooth = false;
+    for (int i = 1; i < argc; ++i) {
+        const std::string arg = argv[i];
+        if (arg == "--render-scale" && i + 1 < argc) {
+            renderScale = static_cast<float>(std::atof(argv[++i]));
+        } else if (arg == "--render-smooth") {
+            renderSmooth = true;
+        } else if (arg == "--no-dynamic-resolution") {
+            game.setDynamicResolution(false);
+        } else if (arg == "--single-thread") {
+            game.setThreadedRendering(false);
+        } else if (arg == "--job-stats") {
+            game.setJobStats(true);
+        } else if (arg == "--font-stats") {
+            game.setFontStats(true);
+        }
+    }
+    if (renderScale > 0.0f && renderScale < 1.0f) {
+        game.setDynamicResolution(false);
+        game.setRenderScale(renderScale, renderSmooth);
+    }
+
     game.run();
     return 0;
-}
\ No newline at end of file
+}
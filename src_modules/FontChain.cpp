@@ -0,0 +1,62 @@
+#include "FontChain.hpp"
+#include "Utf8Text.hpp"
+
+namespace {
+    const FontHandle kNoFont;
+}
+
+void FontChain::add(FontHandle font) {
+    // An empty sf::Font (failed load) has no family name
+    if (font && !font->getInfo().family.empty()) {
+        _fonts.push_back(std::move(font));
+    }
+}
+
+const FontHandle& FontChain::primary() const {
+    return _fonts.empty() ? kNoFont : _fonts.front();
+}
+
+const FontHandle& FontChain::select(const std::string& text) const {
+    // Plain ASCII is what the primary font is for; skip the glyph lookups
+    if (_fonts.size() < 2 || Utf8Text::isAscii(text)) {
+        return primary();
+    }
+    return select(Utf8Text::decode(text));
+}
+
+const FontHandle& FontChain::select(const sf::String& text) const {
+    if (_fonts.size() < 2) {
+        return primary();
+    }
+
+    // First font covering the whole string; else the one missing the fewest
+    const FontHandle* best = &_fonts.front();
+    std::size_t bestMissing = text.getSize() + 1;
+    for (const FontHandle& font : _fonts) {
+        std::size_t missing = 0;
+        for (sf::Uint32 codePoint : text) {
+            if (codePoint > L' ' && !font->hasGlyph(codePoint)) {
+                ++missing;
+            }
+        }
+        if (missing == 0) {
+            return font;
+        }
+        if (missing < bestMissing) {
+            best = &font;
+            bestMissing = missing;
+        }
+    }
+    return *best;
+}
+
+void FontChain::prewarm(const std::string& text, unsigned int characterSize, bool bold) const {
+    const sf::String decoded = Utf8Text::decode(text);
+    const FontHandle& font = select(decoded);
+    if (!font) return;
+
+    for (sf::Uint32 codePoint : decoded) {
+        font->getGlyph(codePoint, characterSize, bold);
+    }
+    FontRegistry::instance().noteCharacterSize(*font, characterSize);
+}
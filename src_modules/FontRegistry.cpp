@@ -0,0 +1,93 @@
+#include "FontRegistry.hpp"
+#include <fstream>
+#include <iterator>
+
+FontRegistry& FontRegistry::instance() {
+    static FontRegistry registry;
+    return registry;
+}
+
+FontHandle FontRegistry::acquire(const std::string& path) {
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        auto it = _fonts.find(path);
+        if (it != _fonts.end()) {
+            return it->second.font;
+        }
+    }
+
+    // Read and open outside the lock, so fonts can load in parallel.
+    // Read the file ourselves so the exact resident size is known
+    Entry entry;
+    std::ifstream file(path, std::ios::binary);
+    if (file) {
+        entry.source.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+    }
+
+    entry.font = std::make_shared<sf::Font>();
+    if (entry.source.empty() ||
+        !entry.font->loadFromMemory(entry.source.data(), entry.source.size())) {
+        return std::make_shared<const sf::Font>();
+    }
+
+    // Whoever finished first wins; a duplicate load is just dropped
+    std::lock_guard<std::mutex> lock(_mutex);
+    auto inserted = _fonts.emplace(path, std::move(entry));
+    return inserted.first->second.font;
+}
+
+void FontRegistry::noteCharacterSize(const sf::Font& font, unsigned int size) {
+    std::lock_guard<std::mutex> lock(_mutex);
+    for (auto& pair : _fonts) {
+        if (pair.second.font.get() == &font) {
+            pair.second.characterSizes.insert(size);
+            return;
+        }
+    }
+}
+
+void FontRegistry::releaseUnused() {
+    std::lock_guard<std::mutex> lock(_mutex);
+    for (auto it = _fonts.begin(); it != _fonts.end();) {
+        if (it->second.font.use_count() == 1) {
+            it = _fonts.erase(it);
+        } else {
+            ++it;
+        }
+    }
+}
+
+FontRegistry::FontUsage FontRegistry::describe(const std::string& path, const Entry& entry) const {
+    FontUsage usage;
+    usage.path = path;
+    usage.handles = entry.font.use_count() - 1;
+    usage.sourceBytes = entry.source.size();
+    usage.textureBytes = 0;
+
+    // One RGBA page per character size; only noted sizes are queried, since
+    // asking for any other size would create an empty page
+    for (unsigned int size : entry.characterSizes) {
+        sf::Vector2u pageSize = entry.font->getTexture(size).getSize();
+        usage.textureBytes += static_cast<std::size_t>(pageSize.x) * pageSize.y * 4;
+        usage.characterSizes.push_back(size);
+    }
+    return usage;
+}
+
+std::vector<FontRegistry::FontUsage> FontRegistry::report() const {
+    std::lock_guard<std::mutex> lock(_mutex);
+    std::vector<FontUsage> usages;
+    usages.reserve(_fonts.size());
+    for (const auto& pair : _fonts) {
+        usages.push_back(describe(pair.first, pair.second));
+    }
+    return usages;
+}
+
+std::size_t FontRegistry::getMemoryUsage() const {
+    std::size_t total = 0;
+    for (const FontUsage& usage : report()) {
+        total += usage.sourceBytes + usage.textureBytes;
+    }
+    return total;
+}
@@ -0,0 +1,74 @@
+#include "FrameGovernor.hpp"
+#include <algorithm>
+
+namespace {
+    const float kSmoothing = 0.1f;          // Weight of the newest frame in the average
+    const float kOverBudget = 1.1f;         // Average above target * this is too slow
+    const float kUnderBudget = 0.75f;       // Average below target * this leaves headroom
+    const int kFramesToShrink = 15;         // React to slowdowns within a quarter second
+    const int kFramesToGrow = 120;          // Recover slowly, about two seconds of headroom
+    const int kCooldownFrames = 30;         // Let the average catch up with a new scale
+    const float kShrinkFactor = 0.8f;
+    const float kGrowFactor = 1.1f;
+    const float kDefaultMinScale = 0.2f;
+    const float kMaxFrameTime = 0.25f;      // Ignore hitches (window drag, breakpoints)
+}
+
+FrameGovernor::FrameGovernor(float targetFrameTime)
+    : _target(targetFrameTime)
+    , _minScale(kDefaultMinScale)
+    , _scale(1.0f)
+    , _average(targetFrameTime * kUnderBudget)
+    , _overFrames(0)
+    , _underFrames(0)
+    , _cooldown(0)
+    , _mayShrink(true)
+    , _mayGrow(true)
+{
+}
+
+bool FrameGovernor::addFrame(float seconds) {
+    seconds = std::min(seconds, kMaxFrameTime);
+    _average += (seconds - _average) * kSmoothing;
+
+    if (_cooldown > 0) {
+        --_cooldown;
+        return false;
+    }
+
+    // Count how long the average has been outside the dead band
+    if (_average > _target * kOverBudget) {
+        ++_overFrames;
+        _underFrames = 0;
+    } else if (_average < _target * kUnderBudget) {
+        ++_underFrames;
+        _overFrames = 0;
+    } else {
+        _overFrames = 0;
+        _underFrames = 0;
+    }
+    if (!_mayShrink) _overFrames = 0;
+    if (!_mayGrow) _underFrames = 0;
+
+    float scale = _scale;
+    if (_overFrames >= kFramesToShrink) {
+        scale = std::max(_minScale, _scale * kShrinkFactor);
+    } else if (_underFrames >= kFramesToGrow) {
+        scale = std::min(1.0f, _scale * kGrowFactor);
+    }
+
+    if (scale == _scale) {
+        // Already at a limit: keep counting from zero rather than firing every frame
+        if (_overFrames >= kFramesToShrink || _underFrames >= kFramesToGrow) {
+            _overFrames = 0;
+            _underFrames = 0;
+        }
+        return false;
+    }
+
+    _scale = scale;
+    _overFrames = 0;
+    _underFrames = 0;
+    _cooldown = kCooldownFrames;
+    return true;
+}
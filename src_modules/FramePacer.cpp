@@ -0,0 +1,72 @@
+#include "FramePacer.hpp"
+#include <algorithm>
+
+namespace {
+    const float kDefaultActiveRate = 60.0f;
+    const float kDefaultIdleRate = 15.0f;      // Enough for the slow glows and drifting particles
+    const float kDefaultActiveHold = 2.5f;     // Outlasts the longest particle burst
+    const float kDefaultSleepAfter = 30.0f;
+    const sf::Time kInputPoll = sf::milliseconds(8);  // Longest input goes unnoticed between frames
+}
+
+FramePacer::FramePacer()
+    : _activeInterval(sf::seconds(1.0f / kDefaultActiveRate))
+    , _idleInterval(sf::seconds(1.0f / kDefaultIdleRate))
+    , _activeHold(sf::seconds(kDefaultActiveHold))
+    , _sleepAfter(sf::seconds(kDefaultSleepAfter))
+    , _mode(Mode::Active)
+    , _forceFrame(true)
+{
+}
+
+void FramePacer::setActiveRate(float framesPerSecond) {
+    _activeInterval = sf::seconds(1.0f / std::max(1.0f, framesPerSecond));
+}
+
+void FramePacer::setIdleRate(float framesPerSecond) {
+    _idleInterval = sf::seconds(1.0f / std::max(1.0f, framesPerSecond));
+}
+
+void FramePacer::wake() {
+    _lastActivity = _clock.getElapsedTime();
+    // Already at full rate the next frame is at most one interval away;
+    // forcing it would let a stream of events (mouse moves) uncap the rate
+    if (_mode != Mode::Active) {
+        _mode = Mode::Active;
+        _forceFrame = true;
+    }
+}
+
+sf::Time FramePacer::frameInterval() const {
+    return _mode == Mode::Active ? _activeInterval : _idleInterval;
+}
+
+bool FramePacer::isFrameDue() const {
+    return _forceFrame || _clock.getElapsedTime() - _lastFrame >= frameInterval();
+}
+
+sf::Time FramePacer::getWaitTime() const {
+    const sf::Time untilDue = frameInterval() - (_clock.getElapsedTime() - _lastFrame);
+    return std::max(sf::Time::Zero, std::min(untilDue, kInputPoll));
+}
+
+void FramePacer::frameStarted() {
+    _lastFrame = _clock.getElapsedTime();
+    _forceFrame = false;
+}
+
+void FramePacer::frameDone(bool busy) {
+    const sf::Time now = _clock.getElapsedTime();
+    if (busy) {
+        _lastActivity = now;
+    }
+
+    const sf::Time quiet = now - _lastActivity;
+    if (quiet < _activeHold) {
+        _mode = Mode::Active;
+    } else if (_sleepAfter == sf::Time::Zero || quiet < _sleepAfter) {
+        _mode = Mode::Idle;
+    } else {
+        _mode = Mode::Sleep;
+    }
+}
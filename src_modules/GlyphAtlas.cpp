@@ -0,0 +1,252 @@
+#include "GlyphAtlas.hpp"
+#include <algorithm>
+#include <fstream>
+#include <limits>
+
+namespace {
+    std::uint64_t pairKey(sf::Uint32 first, sf::Uint32 second) {
+        return (static_cast<std::uint64_t>(first) << 32) | second;
+    }
+
+    const sf::Glyph kEmptyGlyph;
+}
+
+BakedFace::BakedFace(unsigned int characterSize, bool bold, float lineSpacing)
+    : _characterSize(characterSize)
+    , _bold(bold)
+    , _lineSpacing(lineSpacing)
+{
+}
+
+const sf::Glyph* BakedFace::findGlyph(sf::Uint32 codePoint) const {
+    auto it = _glyphs.find(codePoint);
+    return it != _glyphs.end() ? &it->second : nullptr;
+}
+
+const sf::Glyph& BakedFace::getGlyph(sf::Uint32 codePoint) const {
+    const sf::Glyph* glyph = findGlyph(codePoint);
+    return glyph ? *glyph : kEmptyGlyph;
+}
+
+float BakedFace::getKerning(sf::Uint32 first, sf::Uint32 second) const {
+    if (first == 0 || second == 0 || _kerning.empty()) return 0.0f;
+    auto it = _kerning.find(pairKey(first, second));
+    return it != _kerning.end() ? it->second : 0.0f;
+}
+
+bool BakedFace::covers(const sf::String& text) const {
+    for (sf::Uint32 codePoint : text) {
+        // Tabs and line breaks are laid out, not drawn
+        if (codePoint == L'\n' || codePoint == L'\r') continue;
+        if (codePoint == L'\t') codePoint = L' ';
+        if (!findGlyph(codePoint)) return false;
+    }
+    return true;
+}
+
+void BakedFace::addGlyph(sf::Uint32 codePoint, const sf::Glyph& glyph) {
+    _glyphs[codePoint] = glyph;
+}
+
+void BakedFace::addKerning(sf::Uint32 first, sf::Uint32 second, float amount) {
+    if (amount != 0.0f) {
+        _kerning[pairKey(first, second)] = amount;
+    }
+}
+
+GlyphAtlas::GlyphAtlas() = default;
+
+GlyphAtlas& GlyphAtlas::instance() {
+    static GlyphAtlas atlas;
+    return atlas;
+}
+
+bool GlyphAtlas::loadFromFile(const std::string& imagePath, const std::string& metricsPath) {
+    sf::Image image;
+    if (!image.loadFromFile(imagePath)) {
+        _faces.clear();
+        _family.clear();
+        return false;
+    }
+    return loadFromImage(image, metricsPath);
+}
+
+bool GlyphAtlas::loadFromImage(const sf::Image& image, const std::string& metricsPath) {
+    if (!loadMetrics(metricsPath) || !_texture.loadFromImage(image)) {
+        _faces.clear();
+        _family.clear();
+        return false;
+    }
+    // Same filtering as sf::Font's glyph pages
+    _texture.setSmooth(true);
+    return true;
+}
+
+bool GlyphAtlas::loadMetrics(const std::string& metricsPath) {
+    std::ifstream file(metricsPath);
+    if (!file) return false;
+
+    std::string tag;
+    int version = 0;
+    std::size_t faceCount = 0;
+    if (!(file >> tag >> version >> faceCount) || tag != "atlas" || version != kVersion) {
+        return false;
+    }
+    std::getline(file >> std::ws, _family);
+
+    std::vector<BakedFace> faces;
+    faces.reserve(faceCount);
+    for (std::size_t f = 0; f < faceCount; ++f) {
+        unsigned int size = 0;
+        int bold = 0;
+        float lineSpacing = 0.0f;
+        std::size_t glyphCount = 0;
+        std::size_t kerningCount = 0;
+        if (!(file >> tag >> size >> bold >> lineSpacing >> glyphCount >> kerningCount) || tag != "face") {
+            return false;
+        }
+
+        BakedFace face(size, bold != 0, lineSpacing);
+        for (std::size_t g = 0; g < glyphCount; ++g) {
+            sf::Uint32 codePoint = 0;
+            sf::Glyph glyph;
+            if (!(file >> tag >> codePoint >> glyph.advance
+                       >> glyph.bounds.left >> glyph.bounds.top >> glyph.bounds.width >> glyph.bounds.height
+                       >> glyph.textureRect.left >> glyph.textureRect.top
+                       >> glyph.textureRect.width >> glyph.textureRect.height) || tag != "g") {
+                return false;
+            }
+            face.addGlyph(codePoint, glyph);
+        }
+        for (std::size_t k = 0; k < kerningCount; ++k) {
+            sf::Uint32 first = 0;
+            sf::Uint32 second = 0;
+            float amount = 0.0f;
+            if (!(file >> tag >> first >> second >> amount) || tag != "k") {
+                return false;
+            }
+            face.addKerning(first, second, amount);
+        }
+        faces.push_back(std::move(face));
+    }
+
+    _faces = std::move(faces);
+    return true;
+}
+
+bool GlyphAtlas::saveMetrics(const std::string& metricsPath) const {
+    std::ofstream file(metricsPath);
+    if (!file) return false;
+
+    file.precision(std::numeric_limits<float>::max_digits10);
+    file << "atlas " << kVersion << ' ' << _faces.size() << ' ' << _family << '\n';
+    for (const BakedFace& face : _faces) {
+        // Sorted so a rebake of the same font gives the same file
+        std::vector<sf::Uint32> codePoints;
+        for (const auto& pair : face.getGlyphs()) codePoints.push_back(pair.first);
+        std::sort(codePoints.begin(), codePoints.end());
+        std::vector<std::pair<std::uint64_t, float>> kerning(face.getKerningPairs().begin(), face.getKerningPairs().end());
+        std::sort(kerning.begin(), kerning.end());
+
+        file << "face " << face.getCharacterSize() << ' ' << (face.isBold() ? 1 : 0) << ' '
+             << face.getLineSpacing() << ' ' << codePoints.size() << ' ' << kerning.size() << '\n';
+        for (sf::Uint32 codePoint : codePoints) {
+            const sf::Glyph& glyph = face.getGlyph(codePoint);
+            file << "g " << codePoint << ' ' << glyph.advance << ' '
+                 << glyph.bounds.left << ' ' << glyph.bounds.top << ' '
+                 << glyph.bounds.width << ' ' << glyph.bounds.height << ' '
+                 << glyph.textureRect.left << ' ' << glyph.textureRect.top << ' '
+                 << glyph.textureRect.width << ' ' << glyph.textureRect.height << '\n';
+        }
+        for (const auto& pair : kerning) {
+            file << "k " << (pair.first >> 32) << ' ' << (pair.first & 0xFFFFFFFFu) << ' ' << pair.second << '\n';
+        }
+    }
+    return static_cast<bool>(file);
+}
+
+bool GlyphAtlas::isBakedFrom(const sf::Font& font) const {
+    return !_family.empty() && font.getInfo().family == _family;
+}
+
+const BakedFace* GlyphAtlas::findFace(unsigned int characterSize, bool bold) const {
+    for (const BakedFace& face : _faces) {
+        if (face.getCharacterSize() == characterSize && face.isBold() == bold) {
+            return &face;
+        }
+    }
+    return nullptr;
+}
+
+std::size_t GlyphAtlas::getMemoryUsage() const {
+    const sf::Vector2u size = _texture.getSize();
+    return static_cast<std::size_t>(size.x) * size.y * 4;
+}
+
+void GlyphAtlas::addFace(BakedFace face) {
+    _faces.push_back(std::move(face));
+}
+
+sf::FloatRect GlyphAtlas::appendText(const BakedFace& face, const sf::String& text, float lineSpacing,
+                                     const sf::Color& color, sf::VertexArray& vertices) {
+    // Same rules as sf::Text: kerning, whitespace advances, one quad with a
+    // 1px padding per visible glyph
+    const float whitespaceWidth = face.getGlyph(L' ').advance;
+    const float lineHeight = face.getLineSpacing() * lineSpacing;
+    const float padding = 1.0f;
+
+    float x = 0.0f;
+    float y = static_cast<float>(face.getCharacterSize());
+    float minX = static_cast<float>(face.getCharacterSize());
+    float minY = static_cast<float>(face.getCharacterSize());
+    float maxX = 0.0f;
+    float maxY = 0.0f;
+    sf::Uint32 previous = 0;
+
+    for (sf::Uint32 current : text) {
+        if (current == L'\r') continue;
+        x += face.getKerning(previous, current);
+        previous = current;
+
+        if (current == L' ' || current == L'\t' || current == L'\n') {
+            minX = std::min(minX, x);
+            minY = std::min(minY, y);
+            if (current == L' ') x += whitespaceWidth;
+            else if (current == L'\t') x += whitespaceWidth * 4.0f;
+            else { y += lineHeight; x = 0.0f; }
+            maxX = std::max(maxX, x);
+            maxY = std::max(maxY, y);
+            continue;
+        }
+
+        const sf::Glyph& glyph = face.getGlyph(current);
+        float left = x + glyph.bounds.left;
+        float top = y + glyph.bounds.top;
+        float right = left + glyph.bounds.width;
+        float bottom = top + glyph.bounds.height;
+
+        float u1 = static_cast<float>(glyph.textureRect.left) - padding;
+        float v1 = static_cast<float>(glyph.textureRect.top) - padding;
+        float u2 = static_cast<float>(glyph.textureRect.left + glyph.textureRect.width) + padding;
+        float v2 = static_cast<float>(glyph.textureRect.top + glyph.textureRect.height) + padding;
+
+        vertices.append(sf::Vertex(sf::Vector2f(left - padding, top - padding), color, sf::Vector2f(u1, v1)));
+        vertices.append(sf::Vertex(sf::Vector2f(right + padding, top - padding), color, sf::Vector2f(u2, v1)));
+        vertices.append(sf::Vertex(sf::Vector2f(left - padding, bottom + padding), color, sf::Vector2f(u1, v2)));
+        vertices.append(sf::Vertex(sf::Vector2f(left - padding, bottom + padding), color, sf::Vector2f(u1, v2)));
+        vertices.append(sf::Vertex(sf::Vector2f(right + padding, top - padding), color, sf::Vector2f(u2, v1)));
+        vertices.append(sf::Vertex(sf::Vector2f(right + padding, bottom + padding), color, sf::Vector2f(u2, v2)));
+
+        minX = std::min(minX, left);
+        maxX = std::max(maxX, right);
+        minY = std::min(minY, top);
+        maxY = std::max(maxY, bottom);
+
+        x += glyph.advance;
+    }
+
+    if (maxX < minX || maxY < minY) {
+        return sf::FloatRect();
+    }
+    return sf::FloatRect(minX, minY, maxX - minX, maxY - minY);
+}
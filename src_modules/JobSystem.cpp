@@ -0,0 +1,226 @@
+#include "JobSystem.hpp"
+#include <algorithm>
+
+namespace {
+    // Which pool the current thread works for, and its queue there
+    thread_local const JobSystem* tlsOwner = nullptr;
+    thread_local std::size_t tlsSlot = 0;
+    // Jobs run inside a waiting job are already part of its busy time
+    thread_local int tlsDepth = 0;
+
+    const std::size_t kInitialQueueCapacity = 256;
+}
+
+void JobSystem::Queue::push(const Job& job) {
+    if (size == jobs.size()) {
+        // Unroll into a bigger buffer, oldest job first
+        std::vector<Job> grown(std::max(kInitialQueueCapacity, jobs.size() * 2));
+        for (std::size_t i = 0; i < size; ++i) {
+            grown[i] = jobs[(head + i) % jobs.size()];
+        }
+        jobs.swap(grown);
+        head = 0;
+    }
+    jobs[(head + size) % jobs.size()] = job;
+    ++size;
+}
+
+bool JobSystem::Queue::popBack(Job& job) {
+    if (size == 0) return false;
+    --size;
+    job = jobs[(head + size) % jobs.size()];
+    return true;
+}
+
+bool JobSystem::Queue::popFront(Job& job) {
+    if (size == 0) return false;
+    job = jobs[head];
+    head = (head + 1) % jobs.size();
+    --size;
+    return true;
+}
+
+JobSystem::JobSystem(unsigned int workerCount)
+    : _slotCount(0)
+    , _queued(0)
+    , _waiting(0)
+    , _stopping(false)
+    , _lastSample(std::chrono::steady_clock::now())
+{
+    if (workerCount == 0) {
+        unsigned int hardware = std::thread::hardware_concurrency();
+        workerCount = hardware > 1 ? hardware - 1 : 0;
+    }
+
+    // Slot 0 is shared by every thread outside the pool
+    _slotCount = workerCount + 1;
+    _queues.reset(new Queue[_slotCount]);
+    _counters.reset(new Counters[_slotCount]);
+    for (std::size_t slot = 0; slot < _slotCount; ++slot) {
+        _queues[slot].jobs.resize(kInitialQueueCapacity);
+    }
+
+    _threads.reserve(workerCount);
+    for (std::size_t slot = 1; slot < _slotCount; ++slot) {
+        _threads.emplace_back(&JobSystem::workerLoop, this, slot);
+    }
+}
+
+JobSystem::~JobSystem() {
+    {
+        std::lock_guard<std::mutex> lock(_sleepMutex);
+        _stopping = true;
+    }
+    _wake.notify_all();
+
+    for (auto& thread : _threads) {
+        thread.join();
+    }
+}
+
+std::size_t JobSystem::currentSlot() const {
+    return tlsOwner == this ? tlsSlot : 0;
+}
+
+void JobSystem::submit(JobFunction function, const void* context, std::size_t first, std::size_t count,
+                       Counter& pending) {
+    if (count == 0) return;
+
+    // Counted before the jobs are visible, so a thief taking one can never
+    // drive the count below zero. Under the sleep mutex so a thread about to
+    // sleep can't miss it.
+    bool waiters;
+    {
+        std::lock_guard<std::mutex> lock(_sleepMutex);
+        _queued.fetch_add(count, std::memory_order_relaxed);
+        waiters = _waiting > 0;
+    }
+
+    Queue& queue = _queues[currentSlot()];
+    {
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        for (std::size_t i = 0; i < count; ++i) {
+            queue.push(Job{function, context, first + i, &pending});
+        }
+    }
+
+    if (count == 1) {
+        _wake.notify_one();
+    } else {
+        _wake.notify_all();
+    }
+    // Blocked waiters help with new jobs too
+    if (waiters) {
+        _progress.notify_all();
+    }
+}
+
+bool JobSystem::findJob(std::size_t slot, Job& job) {
+    if (_queued.load(std::memory_order_relaxed) == 0) return false;
+
+    // Own queue first, newest job
+    {
+        Queue& own = _queues[slot];
+        std::lock_guard<std::mutex> lock(own.mutex);
+        if (own.popBack(job)) {
+            _queued.fetch_sub(1, std::memory_order_relaxed);
+            return true;
+        }
+    }
+
+    // Then steal the oldest job of someone else, starting past ourselves
+    for (std::size_t offset = 1; offset < _slotCount; ++offset) {
+        Queue& victim = _queues[(slot + offset) % _slotCount];
+        std::lock_guard<std::mutex> lock(victim.mutex);
+        if (victim.popFront(job)) {
+            _queued.fetch_sub(1, std::memory_order_relaxed);
+            _counters[slot].steals.fetch_add(1, std::memory_order_relaxed);
+            return true;
+        }
+    }
+    return false;
+}
+
+void JobSystem::execute(std::size_t slot, const Job& job) {
+    const auto start = std::chrono::steady_clock::now();
+    ++tlsDepth;
+    job.function(job.context, job.index);
+    --tlsDepth;
+
+    Counters& counters = _counters[slot];
+    counters.jobs.fetch_add(1, std::memory_order_relaxed);
+    if (tlsDepth == 0) {
+        const auto busy = std::chrono::steady_clock::now() - start;
+        counters.busyNanoseconds.fetch_add(
+            static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(busy).count()),
+            std::memory_order_relaxed);
+    }
+
+    if (job.pending->fetch_sub(1, std::memory_order_acq_rel) == 1) {
+        // Someone may be blocked in wait() on this counter. Taking the mutex
+        // orders the notify after its last look at the counter.
+        bool waiters;
+        {
+            std::lock_guard<std::mutex> lock(_sleepMutex);
+            waiters = _waiting > 0;
+        }
+        if (waiters) {
+            _progress.notify_all();
+        }
+    }
+}
+
+void JobSystem::wait(const Counter& pending) {
+    const std::size_t slot = currentSlot();
+    Job job;
+    while (pending.load(std::memory_order_acquire) != 0) {
+        // Help out while there is anything queued...
+        if (findJob(slot, job)) {
+            execute(slot, job);
+            continue;
+        }
+
+        // ...otherwise what is left runs on other threads: block until it
+        // finished or until new jobs show up to help with
+        std::unique_lock<std::mutex> lock(_sleepMutex);
+        ++_waiting;
+        _progress.wait(lock, [this, &pending] {
+            return pending.load(std::memory_order_acquire) == 0 || _queued.load(std::memory_order_relaxed) > 0;
+        });
+        --_waiting;
+    }
+}
+
+void JobSystem::workerLoop(std::size_t slot) {
+    tlsOwner = this;
+    tlsSlot = slot;
+
+    Job job;
+    while (true) {
+        if (findJob(slot, job)) {
+            execute(slot, job);
+            continue;
+        }
+
+        std::unique_lock<std::mutex> lock(_sleepMutex);
+        _wake.wait(lock, [this] { return _stopping || _queued.load(std::memory_order_relaxed) > 0; });
+        if (_stopping) return;
+    }
+}
+
+std::vector<JobSystem::WorkerStats> JobSystem::sampleStats() {
+    const auto now = std::chrono::steady_clock::now();
+    const double interval = std::chrono::duration<double>(now - _lastSample).count();
+    _lastSample = now;
+
+    std::vector<WorkerStats> stats(_slotCount);
+    for (std::size_t slot = 0; slot < _slotCount; ++slot) {
+        Counters& counters = _counters[slot];
+        WorkerStats& s = stats[slot];
+        s.jobs = counters.jobs.exchange(0, std::memory_order_relaxed);
+        s.steals = counters.steals.exchange(0, std::memory_order_relaxed);
+        s.busySeconds = counters.busyNanoseconds.exchange(0, std::memory_order_relaxed) * 1e-9;
+        s.utilization = interval > 0.0 ? std::min(1.0, s.busySeconds / interval) : 0.0;
+    }
+    return stats;
+}
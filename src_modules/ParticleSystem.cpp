@@ -3,137 +3,846 @@
 #include <chrono>
 #include <cmath>
 
-ParticleSystem::ParticleSystem() 
-    : _rng(std::chrono::steady_clock::now().time_since_epoch().count())
+#if defined(__AVX__)
+#include <immintrin.h>
+#elif defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#elif defined(__ARM_NEON)
+#include <arm_neon.h>
+#endif
+
+namespace {
+    const float kDefaultGravity = 50.0f; // Slight downward drift
+    const unsigned int kCircleTextureSize = 64;
+    const float kDegToRad = 3.14159265f / 180.0f;
+
+    // Below ~1% alpha nothing shows; half a pixel of coverage reads as a dot
+    const float kDefaultLodDropAlpha = 0.01f;
+    const float kDefaultLodPointCoverage = 0.5f;
+
+    // Neighbor visits per particle; bounds the cost inside dense spawn bursts
+    const int kMaxNeighbors = 32;
+}
+
+void ParticleStorage::setCapacity(std::size_t capacity) {
+    posX.resize(capacity);
+    posY.resize(capacity);
+    prevX.resize(capacity);
+    prevY.resize(capacity);
+    velX.resize(capacity);
+    velY.resize(capacity);
+    rotation.resize(capacity);
+    rotationSpeed.resize(capacity);
+    lifetime.resize(capacity);
+    maxLifetime.resize(capacity);
+    size.resize(capacity);
+    gravity.resize(capacity);
+    fade.resize(capacity);
+    response.resize(capacity);
+    color.resize(capacity);
+    colorEnd.resize(capacity);
+    trail.resize(capacity);
+    live = std::min(live, capacity);
+}
+
+void ParticleStorage::write(std::size_t index, const Particle& p) {
+    posX[index] = p.position.x;
+    posY[index] = p.position.y;
+    prevX[index] = p.position.x;
+    prevY[index] = p.position.y;
+    velX[index] = p.velocity.x;
+    velY[index] = p.velocity.y;
+    rotation[index] = p.rotation;
+    rotationSpeed[index] = p.rotationSpeed;
+    lifetime[index] = p.lifetime;
+    maxLifetime[index] = p.maxLifetime;
+    size[index] = p.size;
+    gravity[index] = kDefaultGravity;
+    fade[index] = 0.0f;
+    response[index] = 0.0f;
+    color[index] = p.color;
+    colorEnd[index] = p.color;
+    trail[index] = -1;
+}
+
+void ParticleStorage::copy(std::size_t from, std::size_t to) {
+    posX[to] = posX[from];
+    posY[to] = posY[from];
+    prevX[to] = prevX[from];
+    prevY[to] = prevY[from];
+    velX[to] = velX[from];
+    velY[to] = velY[from];
+    rotation[to] = rotation[from];
+    rotationSpeed[to] = rotationSpeed[from];
+    lifetime[to] = lifetime[from];
+    maxLifetime[to] = maxLifetime[from];
+    size[to] = size[from];
+    gravity[to] = gravity[from];
+    fade[to] = fade[from];
+    response[to] = response[from];
+    color[to] = color[from];
+    colorEnd[to] = colorEnd[from];
+    trail[to] = trail[from];
+}
+
+void ParticleStorage::remove(std::size_t index) {
+    --live;
+    if (index != live) {
+        copy(live, index);
+    }
+}
+
+std::size_t ParticleStorage::compactRange(std::size_t begin, std::size_t end,
+                                          std::int32_t* releasedTrails, std::size_t& releasedCount) {
+    std::size_t i = begin;
+    while (i < end) {
+        if (lifetime[i] <= 0.0f) {
+            if (trail[i] >= 0) {
+                releasedTrails[releasedCount++] = trail[i];
+            }
+            --end;
+            if (i != end) {
+                copy(end, i);
+            }
+        } else {
+            ++i;
+        }
+    }
+    return end - begin;
+}
+
+void ParticleStorage::moveRange(std::size_t from, std::size_t to, std::size_t count) {
+    if (from == to || count == 0) return;
+
+    // Ascending copy is safe for overlapping ranges because to < from
+    std::copy(posX.begin() + from, posX.begin() + from + count, posX.begin() + to);
+    std::copy(posY.begin() + from, posY.begin() + from + count, posY.begin() + to);
+    std::copy(prevX.begin() + from, prevX.begin() + from + count, prevX.begin() + to);
+    std::copy(prevY.begin() + from, prevY.begin() + from + count, prevY.begin() + to);
+    std::copy(velX.begin() + from, velX.begin() + from + count, velX.begin() + to);
+    std::copy(velY.begin() + from, velY.begin() + from + count, velY.begin() + to);
+    std::copy(rotation.begin() + from, rotation.begin() + from + count, rotation.begin() + to);
+    std::copy(rotationSpeed.begin() + from, rotationSpeed.begin() + from + count, rotationSpeed.begin() + to);
+    std::copy(lifetime.begin() + from, lifetime.begin() + from + count, lifetime.begin() + to);
+    std::copy(maxLifetime.begin() + from, maxLifetime.begin() + from + count, maxLifetime.begin() + to);
+    std::copy(size.begin() + from, size.begin() + from + count, size.begin() + to);
+    std::copy(gravity.begin() + from, gravity.begin() + from + count, gravity.begin() + to);
+    std::copy(fade.begin() + from, fade.begin() + from + count, fade.begin() + to);
+    std::copy(response.begin() + from, response.begin() + from + count, response.begin() + to);
+    std::copy(color.begin() + from, color.begin() + from + count, color.begin() + to);
+    std::copy(colorEnd.begin() + from, colorEnd.begin() + from + count, colorEnd.begin() + to);
+    std::copy(trail.begin() + from, trail.begin() + from + count, trail.begin() + to);
+}
+
+ParticleSystem::ParticleSystem(std::size_t capacity)
+    : _overflowPolicy(OverflowPolicy::RecycleOldest)
+    , _budgetScale(1.0f)
+    , _random(static_cast<std::uint64_t>(std::chrono::steady_clock::now().time_since_epoch().count()))
+    , _parallelThreshold(kDefaultParallelThreshold)
+    , _workerCount(0)
+    , _jobs(nullptr)
+    , _circleTextureReady(false)
+    , _drawnQuads(0)
+    , _drawnPoints(0)
+    , _drawnTrailSegments(0)
+    , _gridDirty(true)
+    , _interactionRadius(12.0f)
+    , _interactionStrength(0.0f)
+    , _viewBounds(0.0f, 0.0f, 1200.0f, 800.0f)
+    , _cullMargin(64.0f)
+    , _lodDropAlpha(kDefaultLodDropAlpha)
+    , _lodPointCoverage(kDefaultLodPointCoverage)
 {
+    setCapacity(capacity);
+    setTrailCapacity(kDefaultTrailCapacity);
 }
 
-void ParticleSystem::createMemoryLossEffect(const sf::Vector2f& position, int count) {
-    for (int i = 0; i < count; ++i) {
-        Particle p;
-        p.position = position;
-        p.velocity = randomVelocity(50.0f + (i % 3) * 20.0f);
-        p.color = sf::Color(150, 100, 200, 200); // Purple-ish memory color
-        p.maxLifetime = 1.5f + (i % 5) * 0.2f;
-        p.lifetime = p.maxLifetime;
-        p.size = 3.0f + (i % 4);
-        p.rotation = static_cast<float>(i * 360 / count);
-        p.rotationSpeed = (i % 2 == 0 ? 1.0f : -1.0f) * (100.0f + i * 10.0f);
-        _particles.push_back(p);
+void ParticleSystem::setViewBounds(const sf::FloatRect& bounds, float margin) {
+    _viewBounds = bounds;
+    _cullMargin = margin;
+    _gridDirty = true;
+}
+
+void ParticleSystem::addForceField(const ForceField& field) {
+    FieldTerm term;
+    term.position = field.position;
+    term.radiusSq = field.radius * field.radius;
+    term.inverseRadius = 1.0f / field.radius;
+    term.strength = field.strength;
+    term.radial = field.type == ForceField::Type::Attractor ? 1.0f
+                : field.type == ForceField::Type::Repulsor ? -1.0f : 0.0f;
+    term.tangential = field.type == ForceField::Type::Vortex ? 1.0f : 0.0f;
+    _fieldTerms.push_back(term);
+}
+
+void ParticleSystem::setTrailCapacity(std::size_t capacity) {
+    _trailPoints.resize(capacity * kTrailLength);
+    _trailHead.resize(capacity);
+    _trailCount.resize(capacity);
+    _freeTrails.reserve(capacity);
+    _batch.trails.resize(capacity * (kTrailLength - 1) * 6);
+    _batch.trails.clear();
+    resetTrails();
+}
+
+void ParticleSystem::resetTrails() {
+    // Detach every live particle and put all slots back on the free stack
+    for (std::size_t i = 0; i < _particles.count(); ++i) {
+        _particles.trail[i] = -1;
+    }
+
+    const std::size_t capacity = _trailHead.size();
+    _freeTrails.clear();
+    for (std::size_t slot = capacity; slot-- > 0;) {
+        _freeTrails.push_back(static_cast<std::int32_t>(slot));
     }
 }
 
-void ParticleSystem::createChoiceEffect(const sf::Vector2f& position, const sf::Color& color, int count) {
-    for (int i = 0; i < count; ++i) {
-        Particle p;
-        p.position = position;
-        p.velocity = randomVelocity(80.0f);
-        p.color = sf::Color(color.r, color.g, color.b, 180);
-        p.maxLifetime = 1.0f;
-        p.lifetime = p.maxLifetime;
-        p.size = 2.0f + (i % 3);
-        p.rotation = static_cast<float>(i * 45);
-        p.rotationSpeed = (i % 2 == 0 ? 1.0f : -1.0f) * 200.0f;
-        _particles.push_back(p);
+void ParticleSystem::releaseTrail(std::size_t index) {
+    std::int32_t slot = _particles.trail[index];
+    if (slot >= 0) {
+        _freeTrails.push_back(slot);
+        _particles.trail[index] = -1;
     }
 }
 
-void ParticleSystem::createFloatingParticles(int count) {
-    std::uniform_real_distribution<float> xDist(0.0f, 1200.0f);
-    std::uniform_real_distribution<float> yDist(0.0f, 800.0f);
-    std::uniform_real_distribution<float> speedDist(10.0f, 30.0f);
-    std::uniform_real_distribution<float> lifetimeDist(3.0f, 8.0f);
-    
-    for (int i = 0; i < count; ++i) {
-        Particle p;
-        p.position = sf::Vector2f(xDist(_rng), yDist(_rng));
-        p.velocity = sf::Vector2f(0.0f, -speedDist(_rng));
-        p.color = randomColor(50.0f + (i % 3) * 20.0f); // Subtle ambient particles
-        p.maxLifetime = lifetimeDist(_rng);
-        p.lifetime = p.maxLifetime;
-        p.size = 1.0f + (i % 2);
-        p.rotation = 0.0f;
-        p.rotationSpeed = 0.0f;
-        _particles.push_back(p);
+void ParticleSystem::setInteraction(float radius, float strength) {
+    _gridDirty = _gridDirty || radius != _interactionRadius;
+    _interactionRadius = radius;
+    _interactionStrength = strength;
+}
+
+void ParticleSystem::setLodThresholds(float dropAlpha, float pointCoverage) {
+    _lodDropAlpha = dropAlpha;
+    _lodPointCoverage = pointCoverage;
+}
+
+void ParticleSystem::setCapacity(std::size_t capacity) {
+    // Particles past the new capacity are dropped; give back their trails first
+    for (std::size_t i = capacity; i < _particles.count(); ++i) {
+        releaseTrail(i);
+    }
+    _particles.setCapacity(capacity);
+    _emitSlots.resize(capacity);
+    _victims.resize(capacity);
+    _grid.reserve(capacity);
+    _chunkLive.resize(capacity / kChunkSize + 1);
+    _chunkReleasedTrails.resize(capacity / kChunkSize + 1);
+    _releasedTrails.resize(capacity);
+
+    // Grow the vertex batches up front; clear() keeps the storage
+    _batch.quads.resize(capacity * 6);
+    _batch.quads.clear();
+    _batch.points.resize(capacity);
+    _batch.points.clear();
+}
+
+void ParticleSystem::setJobSystem(JobSystem* jobs) {
+    _ownJobs.reset();
+    _jobs = jobs;
+}
+
+void ParticleSystem::setWorkerCount(unsigned int workerCount) {
+    if (workerCount == _workerCount) return;
+
+    _workerCount = workerCount;
+    if (_ownJobs) {
+        _ownJobs.reset();  // Recreated with the new size on the next parallel update
+        _jobs = nullptr;
+    }
+}
+
+void ParticleSystem::setBudgetScale(float scale) {
+    _budgetScale = std::min(1.0f, std::max(0.01f, scale));
+}
+
+std::size_t ParticleSystem::acquireSlots(std::size_t count) {
+    // Scale the request, rounding up so small bursts never vanish entirely
+    if (_budgetScale < 1.0f && count > 0) {
+        count = static_cast<std::size_t>(std::ceil(static_cast<float>(count) * _budgetScale));
+    }
+
+    const std::size_t capacity = std::max<std::size_t>(1,
+        static_cast<std::size_t>(static_cast<float>(_particles.capacity()) * _budgetScale));
+    count = std::min(count, capacity);
+
+    // Free slots first
+    std::size_t fresh = _particles.live < capacity ? std::min(count, capacity - _particles.live) : 0;
+    for (std::size_t i = 0; i < fresh; ++i) {
+        _emitSlots[i] = static_cast<std::uint32_t>(_particles.live + i);
+    }
+
+    std::size_t evict = count - fresh;
+    if (evict == 0 || _overflowPolicy == OverflowPolicy::DropNew) {
+        _particles.live += fresh;
+        return fresh;
+    }
+
+    // Pick the eviction victims among the particles that were alive before this call.
+    // nth_element is O(n) and works in place on the preallocated scratch.
+    const std::size_t candidates = _particles.live;
+    for (std::size_t i = 0; i < candidates; ++i) {
+        _victims[i] = static_cast<std::uint32_t>(i);
     }
+
+    const float* lifetime = _particles.lifetime.data();
+    const float* maxLifetime = _particles.maxLifetime.data();
+    auto victimsEnd = _victims.begin() + candidates;
+    auto nth = _victims.begin() + (evict - 1);
+    if (_overflowPolicy == OverflowPolicy::RecycleOldest) {
+        std::nth_element(_victims.begin(), nth, victimsEnd,
+            [lifetime, maxLifetime](std::uint32_t a, std::uint32_t b) {
+                return (maxLifetime[a] - lifetime[a]) > (maxLifetime[b] - lifetime[b]);
+            });
+    } else {
+        std::nth_element(_victims.begin(), nth, victimsEnd,
+            [lifetime](std::uint32_t a, std::uint32_t b) { return lifetime[a] < lifetime[b]; });
+    }
+
+    for (std::size_t i = 0; i < evict; ++i) {
+        _emitSlots[fresh + i] = _victims[i];
+        releaseTrail(_victims[i]);
+    }
+
+    _particles.live += fresh;
+    return count;
+}
+
+void ParticleSystem::createMemoryLossEffect(const sf::Vector2f& position, int count) {
+    emit<Emitters::MemoryLoss>(position, count);
+}
+
+void ParticleSystem::createChoiceEffect(const sf::Vector2f& position, const sf::Color& color, int count) {
+    emit<Emitters::Choice>(position, count, color);
+}
+
+void ParticleSystem::createFloatingParticles(int count) {
+    emit<Emitters::Floating>(sf::Vector2f(0.0f, 0.0f), count);
 }
 
 void ParticleSystem::createSparkle(const sf::Vector2f& position, const sf::Color& color) {
-    for (int i = 0; i < 8; ++i) {
-        Particle p;
-        p.position = position;
-        float angle = static_cast<float>(i * 45) * 3.14159f / 180.0f;
-        float speed = 100.0f;
-        p.velocity = sf::Vector2f(std::cos(angle) * speed, std::sin(angle) * speed);
-        p.color = color;
-        p.maxLifetime = 0.5f;
-        p.lifetime = p.maxLifetime;
-        p.size = 4.0f;
-        p.rotation = 0.0f;
-        p.rotationSpeed = 500.0f;
-        _particles.push_back(p);
+    emit<Emitters::Sparkle>(position, 8, color);
+}
+
+std::size_t ParticleSystem::emitBatch(const EmitterDescriptor& d, const sf::Vector2f& position, int count,
+                                      const sf::Color& tint) {
+    const std::size_t n = acquireSlots(static_cast<std::size_t>(std::max(0, count)));
+    if (n == 0) return 0;
+
+    // Runtime twin of emit<>(): the same building blocks, picked once per batch
+    fillPositions(d.shape, n, position, d.areaWidth, d.areaHeight, d.radius);
+
+    const bool constantSpeed = d.minSpeed == d.maxSpeed;
+    if (d.evenAngles) {
+        if (constantSpeed) fillVelocity<true, true>(n, d.minAngle, d.maxAngle, d.minSpeed, d.maxSpeed);
+        else fillVelocity<true, false>(n, d.minAngle, d.maxAngle, d.minSpeed, d.maxSpeed);
+    } else {
+        if (constantSpeed) fillVelocity<false, true>(n, d.minAngle, d.maxAngle, d.minSpeed, d.maxSpeed);
+        else fillVelocity<false, false>(n, d.minAngle, d.maxAngle, d.minSpeed, d.maxSpeed);
+    }
+
+    fillLifetime(n, d.minLifetime, d.maxLifetime);
+    fillUniform<false>(_particles.size, n, d.minSize, d.maxSize);
+    fillUniform<false>(_particles.rotation, n, d.minRotation, d.maxRotation);
+    if (d.alternateSpin) {
+        fillSpin<true>(n, d.minRotationSpeed, d.maxRotationSpeed);
+    } else {
+        fillSpin<false>(n, d.minRotationSpeed, d.maxRotationSpeed);
+    }
+
+    fillConstant(_particles.gravity, n, d.gravity);
+    fillConstant(_particles.fade, n, d.fadeEase);
+    fillConstant(_particles.response, n, d.fieldResponse);
+
+    if (d.trail) {
+        fillTrails(n);
+    } else {
+        fillConstant(_particles.trail, n, std::int32_t(-1));
+    }
+
+    if (d.colorMode == EmitterColorMode::Random) {
+        fillRandomColor(n, d.colorStart.a);
+    } else if (d.colorMode == EmitterColorMode::Tint) {
+        fillConstant(_particles.color, n, sf::Color(tint.r, tint.g, tint.b, d.colorStart.a));
+    } else {
+        fillConstant(_particles.color, n, d.colorStart.toColor());
+    }
+
+    const std::uint32_t* slots = _emitSlots.data();
+    for (std::size_t i = 0; i < n; ++i) {
+        _particles.colorEnd[slots[i]] = d.colorRamp ? d.colorEnd.toColor() : _particles.color[slots[i]];
+    }
+
+    return n;
+}
+
+void ParticleSystem::fillPositions(EmitterShape shape, std::size_t n, const sf::Vector2f& position,
+                                   float width, float height, float radius) {
+    const std::uint32_t* slots = _emitSlots.data();
+    ParticleStorage& p = _particles;
+
+    switch (shape) {
+        case EmitterShape::Point:
+            for (std::size_t i = 0; i < n; ++i) {
+                p.posX[slots[i]] = position.x;
+                p.posY[slots[i]] = position.y;
+            }
+            break;
+        case EmitterShape::Area:
+            for (std::size_t i = 0; i < n; ++i) {
+                p.posX[slots[i]] = position.x + width * _random.nextFloat();
+                p.posY[slots[i]] = position.y + height * _random.nextFloat();
+            }
+            break;
+        case EmitterShape::Ring: {
+            const SinCosTable& table = SinCosTable::instance();
+            for (std::size_t i = 0; i < n; ++i) {
+                float s, c;
+                table.sinCos(_random.nextFloat(), s, c);
+                p.posX[slots[i]] = position.x + c * radius;
+                p.posY[slots[i]] = position.y + s * radius;
+            }
+            break;
+        }
+    }
+
+    // New particles have no motion to interpolate yet
+    for (std::size_t i = 0; i < n; ++i) {
+        p.prevX[slots[i]] = p.posX[slots[i]];
+        p.prevY[slots[i]] = p.posY[slots[i]];
+    }
+}
+
+void ParticleSystem::fillLifetime(std::size_t n, float min, float max) {
+    const std::uint32_t* slots = _emitSlots.data();
+    for (std::size_t i = 0; i < n; ++i) {
+        float lifetime = min == max ? min : _random.range(min, max);
+        _particles.lifetime[slots[i]] = lifetime;
+        _particles.maxLifetime[slots[i]] = lifetime;
+    }
+}
+
+void ParticleSystem::fillTrails(std::size_t n) {
+    // Positions must already be filled: every trail starts at its particle
+    const std::uint32_t* slots = _emitSlots.data();
+    for (std::size_t i = 0; i < n; ++i) {
+        std::uint32_t index = slots[i];
+        if (_freeTrails.empty()) {
+            _particles.trail[index] = -1;
+            continue;
+        }
+
+        std::int32_t slot = _freeTrails.back();
+        _freeTrails.pop_back();
+        _particles.trail[index] = slot;
+        _trailHead[slot] = 0;
+        _trailCount[slot] = 1;
+        _trailPoints[slot * kTrailLength] = sf::Vector2f(_particles.posX[index], _particles.posY[index]);
+    }
+}
+
+void ParticleSystem::fillRandomColor(std::size_t n, sf::Uint8 alpha) {
+    const std::uint32_t* slots = _emitSlots.data();
+    for (std::size_t i = 0; i < n; ++i) {
+        _particles.color[slots[i]] = sf::Color(
+            static_cast<sf::Uint8>(100 + _random.below(156)),
+            static_cast<sf::Uint8>(100 + _random.below(156)),
+            static_cast<sf::Uint8>(100 + _random.below(156)),
+            alpha);
     }
 }
 
 void ParticleSystem::update(float deltaTime) {
-    for (auto& particle : _particles) {
-        // Update position
-        particle.position += particle.velocity * deltaTime;
-        
-        // Update rotation
-        particle.rotation += particle.rotationSpeed * deltaTime;
-        
-        // Update lifetime
-        particle.lifetime -= deltaTime;
-        
-        // Apply gravity/fade
-        particle.velocity.y += 50.0f * deltaTime; // Slight downward drift
-    }
-    
-    // Remove dead particles
-    _particles.erase(
-        std::remove_if(_particles.begin(), _particles.end(),
-            [](const Particle& p) { return p.lifetime <= 0.0f; }),
-        _particles.end()
-    );
-}
-
-void ParticleSystem::draw(sf::RenderWindow& window) {
-    for (const auto& particle : _particles) {
-        float alpha = (particle.lifetime / particle.maxLifetime) * 255.0f;
-        sf::Color drawColor = particle.color;
-        drawColor.a = static_cast<sf::Uint8>(alpha);
-        
-        // Draw as a small circle
-        sf::CircleShape shape(particle.size);
-        shape.setFillColor(drawColor);
-        shape.setPosition(particle.position);
-        shape.setOrigin(particle.size, particle.size);
-        shape.setRotation(particle.rotation);
-        
-        window.draw(shape);
+    const std::size_t n = _particles.count();
+    if (n == 0) return;
+
+    // Work is split into chunks that only write their own slots, so chunks are
+    // independent and can run on any thread
+    const std::size_t chunkCount = (n + kChunkSize - 1) / kChunkSize;
+    const bool parallel = n >= _parallelThreshold && chunkCount > 1;
+    if (parallel && !_jobs) {
+        _ownJobs.reset(new JobSystem(_workerCount));
+        _jobs = _ownJobs.get();
+    }
+    auto runChunks = [this, parallel, chunkCount](const auto& task) {
+        if (parallel) {
+            _jobs->parallelFor(chunkCount, task);
+        } else {
+            for (std::size_t chunk = 0; chunk < chunkCount; ++chunk) {
+                task(chunk);
+            }
+        }
+    };
+
+    const sf::FloatRect keep(_viewBounds.left - _cullMargin, _viewBounds.top - _cullMargin,
+                             _viewBounds.width + 2.0f * _cullMargin, _viewBounds.height + 2.0f * _cullMargin);
+
+    // Forces first, as a separate pass: they read neighbor positions from
+    // every chunk, which must not move until all velocities are updated
+    const bool interact = _interactionStrength > 0.0f;
+    if (interact || !_fieldTerms.empty()) {
+        if (interact) {
+            if (_gridDirty) {
+                _grid.configure(keep, _interactionRadius);
+                _gridDirty = false;
+            }
+            const float* response = _particles.response.data();
+            _grid.build(_particles.posX.data(), _particles.posY.data(), n,
+                        [response](std::size_t i) { return response[i] > 0.0f; });
+        }
+
+        runChunks([this, n, deltaTime](std::size_t chunk) {
+            std::size_t begin = chunk * kChunkSize;
+            applyForces(begin, std::min(n, begin + kChunkSize), deltaTime);
+        });
+    }
+
+    // Integrate, cull and remove dead particles
+    auto updateChunk = [this, n, deltaTime, &keep](std::size_t chunk) {
+        std::size_t begin = chunk * kChunkSize;
+        std::size_t end = std::min(n, begin + kChunkSize);
+        std::copy(_particles.posX.begin() + begin, _particles.posX.begin() + end, _particles.prevX.begin() + begin);
+        std::copy(_particles.posY.begin() + begin, _particles.posY.begin() + end, _particles.prevY.begin() + begin);
+        integrate(_particles, begin, end, deltaTime);
+        recordTrails(begin, end);
+        cull(_particles, begin, end, keep);
+
+        // Each chunk reports freed trail slots into its own part of the scratch
+        std::size_t released = 0;
+        _chunkLive[chunk] = _particles.compactRange(begin, end, _releasedTrails.data() + begin, released);
+        _chunkReleasedTrails[chunk] = released;
+    };
+
+    runChunks(updateChunk);
+
+    // Return freed trail slots to the stack, in chunk order
+    for (std::size_t chunk = 0; chunk < chunkCount; ++chunk) {
+        const std::int32_t* released = _releasedTrails.data() + chunk * kChunkSize;
+        _freeTrails.insert(_freeTrails.end(), released, released + _chunkReleasedTrails[chunk]);
     }
+
+    // Gather every chunk's survivors into [0, live), in chunk order
+    std::size_t live = _chunkLive[0];
+    for (std::size_t chunk = 1; chunk < chunkCount; ++chunk) {
+        _particles.moveRange(chunk * kChunkSize, live, _chunkLive[chunk]);
+        live += _chunkLive[chunk];
+    }
+    _particles.live = live;
 }
 
-void ParticleSystem::clear() {
-    _particles.clear();
+void ParticleSystem::applyForces(std::size_t begin, std::size_t end, float deltaTime) {
+    const float* posX = _particles.posX.data();
+    const float* posY = _particles.posY.data();
+    const float* response = _particles.response.data();
+    float* velX = _particles.velX.data();
+    float* velY = _particles.velY.data();
+
+    const bool interact = _interactionStrength > 0.0f;
+    const float interactionRadiusSq = _interactionRadius * _interactionRadius;
+    const float inverseInteractionRadius = 1.0f / _interactionRadius;
+
+    for (std::size_t i = begin; i < end; ++i) {
+        if (response[i] == 0.0f) continue;
+
+        const float x = posX[i];
+        const float y = posY[i];
+        float ax = 0.0f;
+        float ay = 0.0f;
+
+        for (const FieldTerm& field : _fieldTerms) {
+            float dx = field.position.x - x;
+            float dy = field.position.y - y;
+            float distSq = dx * dx + dy * dy;
+            if (distSq >= field.radiusSq || distSq < 1e-4f) continue;
+
+            // Linear falloff, divided by distance to normalize (dx, dy)
+            float dist = std::sqrt(distSq);
+            float scale = field.strength * (1.0f - dist * field.inverseRadius) / dist;
+            ax += scale * (field.radial * dx - field.tangential * dy);
+            ay += scale * (field.radial * dy + field.tangential * dx);
+        }
+
+        if (interact) {
+            int visited = 0;
+            _grid.forEachNear(x, y, [&](std::uint32_t j) {
+                if (j != i) {
+                    float dx = x - posX[j];
+                    float dy = y - posY[j];
+                    float distSq = dx * dx + dy * dy;
+                    if (distSq < interactionRadiusSq && distSq > 1e-4f) {
+                        float dist = std::sqrt(distSq);
+                        float scale = _interactionStrength * (1.0f - dist * inverseInteractionRadius) / dist;
+                        ax += scale * dx;
+                        ay += scale * dy;
+                    }
+                }
+                return ++visited < kMaxNeighbors;
+            });
+        }
+
+        velX[i] += ax * response[i] * deltaTime;
+        velY[i] += ay * response[i] * deltaTime;
+    }
 }
 
-sf::Color ParticleSystem::randomColor(float alpha) {
-    std::uniform_int_distribution<int> colorDist(100, 255);
-    return sf::Color(
-        colorDist(_rng),
-        colorDist(_rng),
-        colorDist(_rng),
-        static_cast<sf::Uint8>(alpha)
-    );
+void ParticleSystem::integrate(ParticleStorage& storage, std::size_t begin, std::size_t end, float deltaTime) {
+    float* posX = storage.posX.data();
+    float* posY = storage.posY.data();
+    float* velX = storage.velX.data();
+    float* velY = storage.velY.data();
+    float* rotation = storage.rotation.data();
+    const float* rotationSpeed = storage.rotationSpeed.data();
+    float* lifetime = storage.lifetime.data();
+    const float* gravity = storage.gravity.data();
+
+    std::size_t i = begin;
+
+#if defined(__AVX__)
+    const __m256 dt = _mm256_set1_ps(deltaTime);
+    for (; i + 8 <= end; i += 8) {
+        __m256 vy = _mm256_loadu_ps(velY + i);
+        _mm256_storeu_ps(posX + i, _mm256_add_ps(_mm256_loadu_ps(posX + i), _mm256_mul_ps(_mm256_loadu_ps(velX + i), dt)));
+        _mm256_storeu_ps(posY + i, _mm256_add_ps(_mm256_loadu_ps(posY + i), _mm256_mul_ps(vy, dt)));
+        _mm256_storeu_ps(rotation + i, _mm256_add_ps(_mm256_loadu_ps(rotation + i), _mm256_mul_ps(_mm256_loadu_ps(rotationSpeed + i), dt)));
+        _mm256_storeu_ps(lifetime + i, _mm256_sub_ps(_mm256_loadu_ps(lifetime + i), dt));
+        _mm256_storeu_ps(velY + i, _mm256_add_ps(vy, _mm256_mul_ps(_mm256_loadu_ps(gravity + i), dt)));
+    }
+#elif defined(__SSE2__) || defined(_M_X64)
+    const __m128 dt = _mm_set1_ps(deltaTime);
+    for (; i + 4 <= end; i += 4) {
+        __m128 vy = _mm_loadu_ps(velY + i);
+        _mm_storeu_ps(posX + i, _mm_add_ps(_mm_loadu_ps(posX + i), _mm_mul_ps(_mm_loadu_ps(velX + i), dt)));
+        _mm_storeu_ps(posY + i, _mm_add_ps(_mm_loadu_ps(posY + i), _mm_mul_ps(vy, dt)));
+        _mm_storeu_ps(rotation + i, _mm_add_ps(_mm_loadu_ps(rotation + i), _mm_mul_ps(_mm_loadu_ps(rotationSpeed + i), dt)));
+        _mm_storeu_ps(lifetime + i, _mm_sub_ps(_mm_loadu_ps(lifetime + i), dt));
+        _mm_storeu_ps(velY + i, _mm_add_ps(vy, _mm_mul_ps(_mm_loadu_ps(gravity + i), dt)));
+    }
+#elif defined(__ARM_NEON)
+    const float32x4_t dt = vdupq_n_f32(deltaTime);
+    for (; i + 4 <= end; i += 4) {
+        float32x4_t vy = vld1q_f32(velY + i);
+        // vmul + vadd rather than vmla so rounding matches the scalar tail
+        vst1q_f32(posX + i, vaddq_f32(vld1q_f32(posX + i), vmulq_f32(vld1q_f32(velX + i), dt)));
+        vst1q_f32(posY + i, vaddq_f32(vld1q_f32(posY + i), vmulq_f32(vy, dt)));
+        vst1q_f32(rotation + i, vaddq_f32(vld1q_f32(rotation + i), vmulq_f32(vld1q_f32(rotationSpeed + i), dt)));
+        vst1q_f32(lifetime + i, vsubq_f32(vld1q_f32(lifetime + i), dt));
+        vst1q_f32(velY + i, vaddq_f32(vy, vmulq_f32(vld1q_f32(gravity + i), dt)));
+    }
+#endif
+
+    // Scalar tail (and the whole range when no SIMD is available)
+    for (; i < end; ++i) {
+        posX[i] += velX[i] * deltaTime;
+        posY[i] += velY[i] * deltaTime;
+        rotation[i] += rotationSpeed[i] * deltaTime;
+        lifetime[i] -= deltaTime;
+        velY[i] += gravity[i] * deltaTime;
+    }
 }
 
-sf::Vector2f ParticleSystem::randomVelocity(float speed) {
-    std::uniform_real_distribution<float> angleDist(0.0f, 2.0f * 3.14159f);
-    std::uniform_real_distribution<float> speedDist(speed * 0.5f, speed);
-    float angle = angleDist(_rng);
-    float vel = speedDist(_rng);
-    return sf::Vector2f(std::cos(angle) * vel, std::sin(angle) * vel);
+void ParticleSystem::recordTrails(std::size_t begin, std::size_t end) {
+    const std::int32_t* trail = _particles.trail.data();
+    for (std::size_t i = begin; i < end; ++i) {
+        std::int32_t slot = trail[i];
+        if (slot < 0) continue;
+
+        std::uint8_t head = static_cast<std::uint8_t>((_trailHead[slot] + 1) % kTrailLength);
+        _trailHead[slot] = head;
+        _trailPoints[slot * kTrailLength + head] = sf::Vector2f(_particles.posX[i], _particles.posY[i]);
+        if (_trailCount[slot] < kTrailLength) {
+            ++_trailCount[slot];
+        }
+    }
 }
 
+void ParticleSystem::cull(ParticleStorage& storage, std::size_t begin, std::size_t end, const sf::FloatRect& keep) {
+    const float* posX = storage.posX.data();
+    const float* posY = storage.posY.data();
+    float* lifetime = storage.lifetime.data();
+    const float right = keep.left + keep.width;
+    const float bottom = keep.top + keep.height;
+
+    // Branch-free select so the compiler can vectorize it
+    for (std::size_t i = begin; i < end; ++i) {
+        bool inside = posX[i] >= keep.left && posX[i] <= right && posY[i] >= keep.top && posY[i] <= bottom;
+        lifetime[i] = inside ? lifetime[i] : 0.0f;
+    }
+}
+
+void ParticleSystem::draw(sf::RenderTarget& target, float interpolation) {
+    buildBatch(_batch, interpolation);
+    drawBatch(target, _batch);
+}
+
+void ParticleSystem::buildBatch(ParticleBatch& batch, float interpolation) {
+    batch.quadCount = 0;
+    batch.pointCount = 0;
+    batch.trailSegmentCount = 0;
+    _drawnQuads = 0;
+    _drawnPoints = 0;
+    _drawnTrailSegments = 0;
+
+    const std::size_t n = _particles.count();
+    if (n == 0) return;
+
+    // resize() keeps the capacity, so steady-state frames never reallocate
+    batch.quads.resize(n * 6);
+    batch.points.resize(n);
+    batch.trails.resize(_trailHead.size() * (kTrailLength - 1) * 6);
+    const float texSize = static_cast<float>(kCircleTextureSize);
+    const float viewRight = _viewBounds.left + _viewBounds.width;
+    const float viewBottom = _viewBounds.top + _viewBounds.height;
+
+    for (std::size_t i = 0; i < n; ++i) {
+        // Off-screen: skip (update() only kills them past the margin)
+        float size = _particles.size[i];
+        float x = _particles.prevX[i] + (_particles.posX[i] - _particles.prevX[i]) * interpolation;
+        float y = _particles.prevY[i] + (_particles.posY[i] - _particles.prevY[i]) * interpolation;
+        if (x + size < _viewBounds.left || x - size > viewRight ||
+            y + size < _viewBounds.top || y - size > viewBottom) {
+            continue;
+        }
+
+        // t runs 1 -> 0 over the lifetime; fade blends a linear and a quadratic curve
+        float t = _particles.lifetime[i] / _particles.maxLifetime[i];
+        float opacity = t + _particles.fade[i] * (t * t - t);
+        if (opacity < _lodDropAlpha) continue;
+        float alpha = opacity * 255.0f;
+
+        // Color ramp (a no-op when both ends are the same color)
+        const sf::Color& start = _particles.color[i];
+        const sf::Color& end = _particles.colorEnd[i];
+        sf::Color drawColor(
+            static_cast<sf::Uint8>(end.r + (start.r - end.r) * t),
+            static_cast<sf::Uint8>(end.g + (start.g - end.g) * t),
+            static_cast<sf::Uint8>(end.b + (start.b - end.b) * t),
+            static_cast<sf::Uint8>(alpha));
+        sf::Vector2f center(x, y);
+
+        std::int32_t trail = _particles.trail[i];
+        if (trail >= 0) {
+            appendTrail(batch, trail, size * opacity, drawColor);
+        }
+
+        // Barely visible: one point instead of a quad
+        if (size * opacity < _lodPointCoverage) {
+            batch.points[batch.pointCount++] = sf::Vertex(center, drawColor);
+            continue;
+        }
+
+        // Rotated quad around the particle center
+        float angle = _particles.rotation[i] * kDegToRad;
+        float c = std::cos(angle) * size;
+        float s = std::sin(angle) * size;
+
+        sf::Vector2f topLeft     = center + sf::Vector2f(-c + s, -s - c);
+        sf::Vector2f topRight    = center + sf::Vector2f( c + s,  s - c);
+        sf::Vector2f bottomRight = center + sf::Vector2f( c - s,  s + c);
+        sf::Vector2f bottomLeft  = center + sf::Vector2f(-c - s, -s + c);
+
+        sf::Vertex* quad = &batch.quads[batch.quadCount * 6];
+        ++batch.quadCount;
+        quad[0] = sf::Vertex(topLeft, drawColor, sf::Vector2f(0.0f, 0.0f));
+        quad[1] = sf::Vertex(topRight, drawColor, sf::Vector2f(texSize, 0.0f));
+        quad[2] = sf::Vertex(bottomRight, drawColor, sf::Vector2f(texSize, texSize));
+        quad[3] = quad[0];
+        quad[4] = quad[2];
+        quad[5] = sf::Vertex(bottomLeft, drawColor, sf::Vector2f(0.0f, texSize));
+    }
+
+    _drawnQuads = batch.quadCount;
+    _drawnPoints = batch.pointCount;
+    _drawnTrailSegments = batch.trailSegmentCount;
+}
+
+void ParticleSystem::drawBatch(sf::RenderTarget& target, const ParticleBatch& batch) {
+    // Trails go underneath their particles, all in one untextured batch
+    if (batch.trailSegmentCount > 0) {
+        target.draw(&batch.trails[0], batch.trailSegmentCount * 6, sf::Triangles);
+    }
+    if (batch.quadCount > 0) {
+        // Texture needs a GL context, so create it lazily on first draw
+        if (!_circleTextureReady) {
+            createCircleTexture();
+        }
+        target.draw(&batch.quads[0], batch.quadCount * 6, sf::Triangles, sf::RenderStates(&_circleTexture));
+    }
+    if (batch.pointCount > 0) {
+        target.draw(&batch.points[0], batch.pointCount, sf::Points);
+    }
+}
+
+void ParticleSystem::createCircleTexture() {
+    // White disc with a one-pixel feathered edge; the vertex color tints it
+    sf::Image image;
+    image.create(kCircleTextureSize, kCircleTextureSize, sf::Color::Transparent);
+
+    const float radius = kCircleTextureSize * 0.5f;
+    for (unsigned int y = 0; y < kCircleTextureSize; ++y) {
+        for (unsigned int x = 0; x < kCircleTextureSize; ++x) {
+            float dx = x + 0.5f - radius;
+            float dy = y + 0.5f - radius;
+            float coverage = std::max(0.0f, std::min(1.0f, radius - std::sqrt(dx * dx + dy * dy)));
+            image.setPixel(x, y, sf::Color(255, 255, 255, static_cast<sf::Uint8>(coverage * 255.0f)));
+        }
+    }
+
+    _circleTexture.loadFromImage(image);
+    _circleTexture.setSmooth(true);
+    _circleTextureReady = true;
+}
+
+void ParticleSystem::appendTrail(ParticleBatch& batch, std::int32_t slot, float width, const sf::Color& color) {
+    const std::size_t count = _trailCount[slot];
+    if (count < 2) return;
+
+    // Walk from the newest point back to the oldest; width and alpha both
+    // shrink linearly to zero at the tail
+    const sf::Vector2f* points = &_trailPoints[slot * kTrailLength];
+    const std::size_t head = _trailHead[slot];
+    const float step = 1.0f / static_cast<float>(count - 1);
+
+    sf::Vector2f previous = points[head];
+    sf::Vector2f previousLeft = previous;
+    sf::Vector2f previousRight = previous;
+    sf::Color previousColor = color;
+    bool hasEdge = false;
+
+    for (std::size_t k = 1; k < count; ++k) {
+        sf::Vector2f current = points[(head + kTrailLength - k) % kTrailLength];
+        sf::Vector2f delta = current - previous;
+        float length = std::sqrt(delta.x * delta.x + delta.y * delta.y);
+        if (length < 0.01f) continue;  // Particle barely moved, nothing to draw
+
+        // Unit normal of this segment, scaled to half the width at each end
+        sf::Vector2f normal(-delta.y / length, delta.x / length);
+        float taper = 1.0f - static_cast<float>(k) * step;
+        if (!hasEdge) {
+            previousLeft = previous + normal * (width * 0.5f);
+            previousRight = previous - normal * (width * 0.5f);
+            hasEdge = true;
+        }
+        sf::Vector2f left = current + normal * (width * 0.5f * taper);
+        sf::Vector2f right = current - normal * (width * 0.5f * taper);
+        sf::Color currentColor(color.r, color.g, color.b, static_cast<sf::Uint8>(color.a * taper));
+
+        sf::Vertex* quad = &batch.trails[batch.trailSegmentCount * 6];
+        ++batch.trailSegmentCount;
+        quad[0] = sf::Vertex(previousLeft, previousColor);
+        quad[1] = sf::Vertex(previousRight, previousColor);
+        quad[2] = sf::Vertex(right, currentColor);
+        quad[3] = quad[0];
+        quad[4] = quad[2];
+        quad[5] = sf::Vertex(left, currentColor);
+
+        previous = current;
+        previousLeft = left;
+        previousRight = right;
+        previousColor = currentColor;
+    }
+}
+
+void ParticleSystem::clear() {
+    _particles.clear();
+    resetTrails();
+}
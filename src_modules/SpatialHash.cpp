@@ -0,0 +1,25 @@
+#include "SpatialHash.hpp"
+#include <cmath>
+
+SpatialHashGrid::SpatialHashGrid()
+    : _inverseCellSize(1.0f)
+    , _columns(1)
+    , _rows(1)
+    , _cellStart(2, 0)
+    , _entryCount(0)
+{
+}
+
+void SpatialHashGrid::configure(const sf::FloatRect& bounds, float cellSize) {
+    _bounds = bounds;
+    _inverseCellSize = 1.0f / cellSize;
+    _columns = std::max(1, static_cast<int>(std::ceil(bounds.width / cellSize)));
+    _rows = std::max(1, static_cast<int>(std::ceil(bounds.height / cellSize)));
+    _cellStart.assign(static_cast<std::size_t>(_columns) * _rows + 1, 0);
+    _entryCount = 0;
+}
+
+void SpatialHashGrid::reserve(std::size_t count) {
+    _entries.resize(count);
+    _entryCell.resize(count);
+}
@@ -1,5 +1,8 @@
 #include "StoryGame.hpp"
 #include "ParticleSystem.hpp"
+#include "FontRegistry.hpp"
+#include "GlyphAtlas.hpp"
+#include "Utf8Text.hpp"
 #include <iostream>
 #include <algorithm>
 #include <sstream>
@@ -7,40 +10,101 @@
 #include <chrono>
 #include <sstream>
 
+namespace {
+    // Simulation runs in fixed steps whatever the display rate. The step
+    // cap covers the 15 fps idle rate with room to spare; anything slower
+    // (a window drag, a long load) is dropped instead of caught up.
+    const float kSimulationStep = 1.0f / 60.0f;
+    const int kMaxSimulationSteps = 8;
+}
+
 StoryGame::StoryGame() 
     : _window(sf::VideoMode(1200, 800), "Memory Labyrinth", sf::Style::Close)
     , _state(GameState::WakingUp)
     , _steps(0)
     , _memoryPoints(10)
     , _familiarity(0)
+    , _familiarityVersion(0)
+    , _lostMemoriesVersion(0)
     , _currentSceneIndex(0)
     , _rng(std::chrono::steady_clock::now().time_since_epoch().count())
+    , _hasNextScene(false)
+    , _nextSceneFamiliarityVersion(0)
+    , _nextSceneLostMemoriesVersion(0)
     , _gameRunning(true)
     , _selectedChoice(-1)
     , _waitingForInput(false)
     , _showConsequence(false)
     , _consequenceTimer(0.0f)
+    , _simulationTime(0.0f)
+    , _simulatedSeconds(0.0)
+    , _consequenceId(0)
     , _bgColor(sf::Color(20, 20, 30))
+    , _frameSteps(0)
+    , _showJobStats(false)
+    , _showFontStats(false)
+    , _particleBudget(1.0f)
+    , _threadedRendering(std::thread::hardware_concurrency() > 1)
+    , _renderRunning(false)
+    , _shownState(GameState::WakingUp)
+    , _shownScene(false)
+    , _shownChoices(0)
+    , _shownConsequenceId(0)
+    , _effectSeconds(0.0)
+    , _chromeState(GameState::WakingUp)
+    , _chromeShowsTextBox(false)
+    , _pixelClearAll(true)
+    , _usePixelEffect(false)
+    , _renderScale(1.0f)
+    , _renderSmooth(true)
+    , _dynamicResolution(true)
 {
-    _window.setFramerateLimit(60);
+    // Frame rate is paced by _framePacer (60 fps while anything moves)
+    _framePacer.setActiveRate(60.0f);
+
+    // Internal resolution follows frame time; it never goes below half
+    _resolutionGovernor.setMinScale(0.5f);
 
-    // Load font
-    _font.loadFromFile("../assets/Roboto-SemiBold.ttf");
+    // Load fonts (shared with every text object through the registry) and
+    // decode the glyph atlas image side by side on the job system; only the
+    // texture upload needs this thread's GL context.
+    // The CJK font is optional, see download_chinese_font.sh
+    FontHandle cjkFont;
+    sf::Image atlasImage;
+    bool atlasDecoded = false;
+    TaskGraph assets;
+    assets.add("latin font", [this] { _font = FontRegistry::instance().acquire("../assets/Roboto-SemiBold.ttf"); });
+    assets.add("cjk font", [&cjkFont] {
+        cjkFont = FontRegistry::instance().acquire("../assets/SourceHanSansCN-Regular.ttf");
+    });
+    assets.add("atlas image", [&atlasImage, &atlasDecoded] {
+        atlasDecoded = atlasImage.loadFromFile("baked/Roboto-SemiBold.png");
+    });
+    assets.run(_jobs);
+    _fonts.add(_font);
+    _fonts.add(cjkFont);
+
+    // Glyphs baked at build time by FontBaker; without them text is
+    // rasterized through FreeType as before
+    if (atlasDecoded) {
+        GlyphAtlas::instance().loadFromImage(atlasImage, "baked/Roboto-SemiBold.atlas");
+    }
 
     /* =========================
        🎨 TEXT COLOR THEME
        ========================= */
 
     // Title – vivid memory red
-    _titleText.setFont(_font);
+    _titleText.setFonts(_fonts);
     _titleText.setCharacterSize(48);
     _titleText.setFillColor(sf::Color(255, 80, 80));
 
     // Main story text – cool bright white
-    _mainText.setFont(_font);
+    _mainText.setFonts(_fonts);
     _mainText.setCharacterSize(22);
     _mainText.setFillColor(sf::Color(235, 240, 255));
     _mainText.setLineSpacing(1.4f);
+    _mainText.setWrapWidth(1060.0f);
 
         // ===== Base colors (DO NOT CHANGE IN RENDER) =====
     _titleBaseColor       = sf::Color(255, 80, 80);     // Title red
@@ -52,38 +116,57 @@ StoryGame::StoryGame()
     _titleText.setFillColor(_titleBaseColor);
     _mainText.setFillColor(_mainBaseColor);
     _statsText.setFillColor(_statsBaseColor);
-    _consequenceText.setFillColor(_consequenceBaseColor);
 
     for (int i = 0; i < 9; ++i) {
         _choiceTexts[i].setFillColor(_choiceBaseColor);
     }
 
     // Stats – cyber cyan
-    _statsText.setFont(_font);
+    _statsText.setFonts(_fonts);
     _statsText.setCharacterSize(20);
     _statsText.setFillColor(sf::Color(120, 220, 255));
+    _statsText.setWrapWidth(1060.0f);
 
     // Choices – warm readable highlight
     for (int i = 0; i < 9; ++i) {
-        _choiceTexts[i].setFont(_font);
+        _choiceTexts[i].setFonts(_fonts);
         _choiceTexts[i].setCharacterSize(22);
         _choiceTexts[i].setFillColor(sf::Color(255, 225, 190));
+        _choiceTexts[i].setWrapWidth(1045.0f);
     }
 
     // Input – soft white
-    _inputText.setFont(_font);
+    _inputText.setFonts(_fonts);
     _inputText.setCharacterSize(24);
     _inputText.setFillColor(sf::Color(245, 245, 255));
 
-    // Consequence / events – memory flash yellow
-    _consequenceText.setFont(_font);
-    _consequenceText.setCharacterSize(22);
-    _consequenceText.setFillColor(sf::Color(255, 215, 120));
+    // Consequence / events – memory flash yellow, typed out with a glow and a tremor
+    _consequenceTextEffect.setFonts(_fonts);
+    _consequenceTextEffect.setCharacterSize(22);
+    _consequenceTextEffect.setFillColor(_consequenceBaseColor);
+    _consequenceTextEffect.setWrapWidth(1060.0f);
+    _consequenceTextEffect.setTypewriterSpeed(45.0f);
+    _consequenceTextEffect.setShakeIntensity(0.6f);
+    _consequenceTextEffect.setChain<TextEffect::Typewriter, TextEffect::Glow, TextEffect::Shake>();
 
-    /* ========================= */
+    // Static strings are laid out once here
+    _titleText.setString("                  Memory Labyrinth");
+
+    _gameOverTitle.setFonts(_fonts);
+    _gameOverTitle.setString("                         GAME OVER\n");
+    _gameOverTitle.setCharacterSize(42);
+    _gameOverTitle.setStyle(sf::Text::Bold);
+
+    _gameOverStats.setFonts(_fonts);
+    _gameOverStats.setCharacterSize(22);
+    _gameOverStats.setFillColor(sf::Color(255, 220, 180));
 
-    _background.setSize(sf::Vector2f(1200, 800));
-    _background.setFillColor(_bgColor);
+    _exitPrompt.setFonts(_fonts);
+    _exitPrompt.setString(">>> Press ENTER or ESC to exit <<<");
+    _exitPrompt.setCharacterSize(20);
+    _exitPrompt.setStyle(sf::Text::Bold);
+
+    /* ========================= */
 
     _titleBox.setSize(sf::Vector2f(1100, 80));
     _titleBox.setFillColor(sf::Color(30, 30, 45, 200));
@@ -98,7 +181,7 @@ StoryGame::StoryGame()
     _statsBox.setPosition(50.0f, 140.0f);
 
     _textBox.setSize(sf::Vector2f(1100, 400));
-    _textBox.setFillColor(sf::Color(15, 15, 25, 200));
+    _textBox.setFillColor(sf::Color(15, 15, 25, 220));
     _textBox.setOutlineColor(sf::Color(80, 140, 200, 100));
     _textBox.setOutlineThickness(1.0f);
 
@@ -109,13 +192,49 @@ StoryGame::StoryGame()
         _choiceBoxes[i].setOutlineThickness(1.0f);
     }
 
+    // Memory fragments softly push each other apart
+    _particleSystem.setInteraction(10.0f, 60.0f);
+    _particleSystem.setJobSystem(&_jobs);
+
     _ambientParticleInterval = 2.0f;
-    _ambientParticleTimer.restart();
+    _ambientParticleTimer = 0.0f;
+    _ambientRandom.setSeed(_rng());
     _gameOverParticlesCreated = false;
 
+    _mainTextEffect.setFonts(_fonts);
+    _titleTextEffect.setFonts(_fonts);
     _useTextEffects = false;
+    _uiDirty = true;
 
     initializeGame();
+    prewarmGlyphs();
+    buildFrameGraph();
+}
+
+void StoryGame::buildFrameGraph() {
+    // Game logic first: it may emit particles and moves the force fields.
+    // Timers don't depend on it; the snapshot needs everything.
+    TaskGraph::NodeId logic = _frameGraph.add("update", [this] { update(); });
+    TaskGraph::NodeId particles = _frameGraph.add("particles", [this] {
+        for (int i = 0; i < _frameSteps; ++i) {
+            simulateParticles(kSimulationStep);
+        }
+    });
+    TaskGraph::NodeId effects = _frameGraph.add("timers", [this] {
+        for (int i = 0; i < _frameSteps; ++i) {
+            simulateEffects(kSimulationStep);
+        }
+    });
+    TaskGraph::NodeId scene = _frameGraph.add("next scene", [this] { pregenerateScene(); });
+    TaskGraph::NodeId publish = _frameGraph.add("snapshot", [this] {
+        // Draw the particles the leftover fraction of a step past the last one
+        publishFrame(_simulationTime / kSimulationStep);
+    });
+
+    _frameGraph.precede(logic, particles);
+    _frameGraph.precede(logic, scene);
+    _frameGraph.precede(particles, publish);
+    _frameGraph.precede(effects, publish);
 }
 
 void StoryGame::initializeGame() {
@@ -153,6 +272,27 @@ void StoryGame::initializeGame() {
         "You realize you're heading toward a place you once fled from"
     };
     
+    _eventTexts = {
+        "You hear footsteps in the distance, but when you turn around, there's nothing.",
+        "A cold wind blows past, you feel someone watching you.",
+        "You see new writing appear on the wall, but when you approach, it disappears.",
+        "You feel someone calling your name, but the voice comes from all directions.",
+        "You see your shadow moving on the wall, but you haven't moved.",
+        "You hear someone crying, but can't find the source of the sound.",
+        "You feel this street changing, but can't say what's different."
+    };
+    
+    _choiceTemplates = {
+        {"Continue forward", "You take a step, the path beneath your feet seems more familiar"},
+        {"Turn left", "You turn left, a strange feeling washes over you"},
+        {"Turn right", "You turn right, you feel you've walked this path before"},
+        {"Stop and observe", "You stop and carefully observe your surroundings"},
+        {"Check the wall", "You approach the wall and find some blurry writing on it"},
+        {"Look back", "You look back, but the path you came from has become unfamiliar"},
+        {"Quickly walk", "You quicken your pace, wanting to escape this place"},
+        {"Walk slowly", "You slow down, trying to remember every detail"}
+    };
+    
     // Initialize memories
     _memories = {
         {"Your name", 1},
@@ -168,148 +308,324 @@ void StoryGame::initializeGame() {
     };
 }
 
+void StoryGame::prewarmGlyphs() {
+    // Rasterize every glyph the story can show at every size the UI uses,
+    // so a new (especially CJK) character never stalls its first frame
+    std::vector<std::string> texts;
+    texts.insert(texts.end(), _streetDescriptions.begin(), _streetDescriptions.end());
+    texts.insert(texts.end(), _memoryLossTexts.begin(), _memoryLossTexts.end());
+    texts.insert(texts.end(), _familiarityTexts.begin(), _familiarityTexts.end());
+    texts.insert(texts.end(), _eventTexts.begin(), _eventTexts.end());
+    for (const auto& choice : _choiceTemplates) {
+        texts.push_back(choice.first);
+        texts.push_back(choice.second);
+    }
+    for (const Memory& memory : _memories) {
+        texts.push_back(memory.description);
+    }
+
+    // Digits, punctuation and anything typed on a plain keyboard
+    std::string ascii;
+    for (char c = ' '; c < 127; ++c) {
+        ascii += c;
+    }
+    texts.push_back(ascii);
+
+    const struct { unsigned int size; bool bold; } styles[] = {
+        {48, false}, {42, true}, {24, false}, {22, false}, {20, false}, {20, true}
+    };
+
+    // Whatever the baked atlas covers is drawn from it and never rasterized
+    const GlyphAtlas& atlas = GlyphAtlas::instance();
+    const bool baked = atlas.isLoaded() && _font && atlas.isBakedFrom(*_font);
+    for (const std::string& text : texts) {
+        const sf::String decoded = Utf8Text::decode(text);
+        for (const auto& style : styles) {
+            const BakedFace* face = baked ? atlas.findFace(style.size, style.bold) : nullptr;
+            if (face && face->covers(decoded)) continue;
+            _fonts.prewarm(text, style.size, style.bold);
+        }
+    }
+}
+
 void StoryGame::run() {
     sf::Clock clock;
+    sf::Clock workClock;
+
+    // Before the render thread starts using the fonts
+    if (_showFontStats) {
+        printFontStats();
+    }
+
+    // The GL context moves to the render thread; events stay on this one
+    if (_threadedRendering) {
+        _window.setActive(false);
+        _renderRunning = true;
+        _renderThread = std::thread(&StoryGame::renderLoop, this);
+    }
     
     while (_window.isOpen() && _gameRunning) {
-        sf::Time dt = clock.restart();
-        float deltaTime = dt.asSeconds();
-        
         processInput();
-        update();
-        
-        // Update particle system
-        _particleSystem.update(deltaTime);
-        
-        // Update text effects
-        if (_useTextEffects) {
-            _mainTextEffect.update(deltaTime);
-            _titleTextEffect.update(deltaTime);
-            _consequenceTextEffect.update(deltaTime);
+
+        // Between paced frames only input is looked at
+        if (!_framePacer.isFrameDue()) {
+            sf::sleep(_framePacer.getWaitTime());
+            continue;
         }
-        
-        // Update title glow effect
-        _titleGlowIntensity = (std::sin(_glowTimer.getElapsedTime().asSeconds() * 2.0f) + 1.0f) * 0.5f;
-        
-        // Create ambient floating particles periodically
-        if (_ambientParticleTimer.getElapsedTime().asSeconds() >= _ambientParticleInterval) {
-            _particleSystem.createFloatingParticles(3);
-            _ambientParticleTimer.restart();
-            _ambientParticleInterval = 1.5f + (std::rand() % 100) / 100.0f;
+
+        _framePacer.frameStarted();
+        workClock.restart();
+
+        // Idle frames are far apart; the step cap keeps effects from
+        // jumping after a sleep
+        _simulationTime += clock.restart().asSeconds();
+        _simulationTime = std::min(_simulationTime, kSimulationStep * kMaxSimulationSteps);
+
+        _frameSteps = 0;
+        while (_simulationTime >= kSimulationStep) {
+            _simulationTime -= kSimulationStep;
+            _simulatedSeconds += kSimulationStep;
+            ++_frameSteps;
         }
-        
-        if (_showConsequence) {
-            _consequenceTimer -= deltaTime;
-            if (_consequenceTimer <= 0.0f) {
-                _showConsequence = false;
+
+        _particleSystem.setBudgetScale(_particleBudget.load());
+        _frameGraph.run(_jobs);
+
+        if (_uiDirty) {
+            _uiDirty = false;
+            publishUi();
+        }
+
+        if (_threadedRendering) {
+            // Published under the wakeup mutex so the render thread can't miss it
+            {
+                std::lock_guard<std::mutex> lock(_frameMutex);
+                _frames.publish();
+            }
+            _frameReady.notify_one();
+        } else {
+            _frames.publish();
+            _frames.take();
+            renderFrame(_frames.front());
+            _window.display();
+
+            // Judge the frame by everything it cost, presenting included (with
+            // a software rasterizer that is where the drawing happens); the
+            // pacer's sleep between frames is not counted
+            judgeFrame(workClock.getElapsedTime().asSeconds());
+        }
+
+        // Fades and typewriters need the full rate; glows and drifting particles do not
+        bool busy = _showConsequence || _useTextEffects;
+        _framePacer.frameDone(busy);
+
+        if (_showJobStats && _jobStatsClock.getElapsedTime().asSeconds() >= 5.0f) {
+            printJobStats();
+            _jobStatsClock.restart();
+        }
+
+        // Asleep and nothing left moving: the frame on screen stays valid,
+        // so block until the next event instead of drawing it again
+        if (_framePacer.isSleeping() && _particleSystem.getParticleCount() == 0) {
+            sf::Event event;
+            if (_window.waitEvent(event)) {
+                handleEvent(event);
             }
         }
-        
-        render();
+    }
+
+    if (_renderThread.joinable()) {
+        {
+            std::lock_guard<std::mutex> lock(_frameMutex);
+            _renderRunning = false;
+        }
+        _frameReady.notify_one();
+        _renderThread.join();
+        _window.setActive(true);
+    }
+    _window.close();
+}
+
+void StoryGame::publishFrame(float interpolation) {
+    FrameSnapshot& frame = _frames.back();
+    _particleSystem.buildBatch(frame.particles, interpolation);
+    frame.showConsequence = _showConsequence;
+    frame.consequenceFade = std::max(0.0f, std::min(1.0f, _consequenceTimer / 3.0f));
+    frame.simulatedSeconds = _simulatedSeconds;
+}
+
+void StoryGame::renderLoop() {
+    _window.setActive(true);
+    sf::Clock workClock;
+
+    while (true) {
+        {
+            std::unique_lock<std::mutex> lock(_frameMutex);
+            _frameReady.wait(lock, [this] { return _frames.hasFresh() || !_renderRunning; });
+            if (!_renderRunning) break;
+        }
+
+        // Only the newest frame is drawn; ones published meanwhile are skipped
+        _frames.take();
+        workClock.restart();
+        renderFrame(_frames.front());
+        _window.display();
+        judgeFrame(workClock.getElapsedTime().asSeconds());
+    }
+
+    _window.setActive(false);
+}
+
+void StoryGame::judgeFrame(float workTime) {
+    // One after the other rather than both at once: particles are shed
+    // first and the resolution only drops once they are at their floor;
+    // on the way back the resolution is restored before particles grow
+    _resolutionGovernor.setMayShrink(_frameGovernor.isAtMin());
+    _frameGovernor.setMayGrow(!_dynamicResolution || _resolutionGovernor.isAtMax());
+
+    if (_frameGovernor.addFrame(workTime)) {
+        _particleBudget.store(_frameGovernor.getScale());
+    }
+    if (_dynamicResolution && _resolutionGovernor.addFrame(workTime)) {
+        setRenderScale(_resolutionGovernor.getScale(), _renderSmooth);
+    }
+}
+
+void StoryGame::simulateParticles(float step) {
+    _particleSystem.update(step);
+
+    // Create ambient floating particles periodically (not while asleep,
+    // so the screen can settle)
+    _ambientParticleTimer += step;
+    if (!_framePacer.isSleeping() && _ambientParticleTimer >= _ambientParticleInterval) {
+        _particleSystem.createFloatingParticles(3);
+        _ambientParticleTimer = 0.0f;
+        _ambientParticleInterval = _ambientRandom.range(1.5f, 2.5f);
+    }
+}
+
+void StoryGame::simulateEffects(float step) {
+    if (_showConsequence) {
+        _consequenceTimer -= step;
+        if (_consequenceTimer <= 0.0f) {
+            _showConsequence = false;
+        }
     }
 }
 
 void StoryGame::processInput() {
     sf::Event event;
     while (_window.pollEvent(event)) {
-        if (event.type == sf::Event::Closed) {
-            _window.close();
+        handleEvent(event);
+    }
+}
+
+void StoryGame::handleEvent(const sf::Event& event) {
+    // Any event (input, focus, resize) may change what is on screen
+    _framePacer.wake();
+
+    // Everything the UI shows changes only in response to input
+    if (event.type == sf::Event::KeyPressed || event.type == sf::Event::TextEntered) {
+        _uiDirty = true;
+    }
+
+    // The window is closed by run(), once the render thread is done with it
+    if (event.type == sf::Event::Closed) {
+        _gameRunning = false;
+    }
+    
+    if (event.type == sf::Event::KeyPressed) {
+        if (event.key.code == sf::Keyboard::Escape) {
             _gameRunning = false;
         }
         
-        if (event.type == sf::Event::KeyPressed) {
-            if (event.key.code == sf::Keyboard::Escape) {
-                _window.close();
-                _gameRunning = false;
-            }
-            
-            if (_state == GameState::WakingUp) {
-                if (event.key.code == sf::Keyboard::Enter) {
-                    if (!_currentInput.empty() && _playerName.empty()) {
-                        // First Enter: confirm name
-                        _playerName = _currentInput;
-                        _currentInput.clear();
-                    } else if (!_playerName.empty()) {
-                        // Second Enter: start game
-                        _state = GameState::Exploring;
-                        _scenes.push_back(generateRandomScene());
-                    }
-                } else if (event.key.code == sf::Keyboard::C && !_playerName.empty()) {
-                    // C key: start game if name is set
+        if (_state == GameState::WakingUp) {
+            if (event.key.code == sf::Keyboard::Enter) {
+                if (!_currentInput.empty() && _playerName.empty()) {
+                    // First Enter: confirm name
+                    _playerName = _currentInput;
+                    _currentInput.clear();
+                } else if (!_playerName.empty()) {
+                    // Second Enter: start game
                     _state = GameState::Exploring;
                     _scenes.push_back(generateRandomScene());
                 }
-            } else if (_state == GameState::Exploring) {
-                if (event.key.code >= sf::Keyboard::Num1 && 
-                    event.key.code <= sf::Keyboard::Num9) {
-                    int choice = event.key.code - sf::Keyboard::Num1 + 1;
-                    if (!_scenes.empty() && choice > 0 && 
-                        choice <= static_cast<int>(_scenes.back().choices.size())) {
-                        Choice& selectedChoice = _scenes.back().choices[choice - 1];
-                        
-                        // Create particle effect for choice selection
-                        float choiceY = 280.0f + (choice - 1) * 35.0f;
-                        _particleSystem.createChoiceEffect(
-                            sf::Vector2f(100.0f, choiceY), 
-                            sf::Color(100, 200, 255), 
-                            15
-                        );
-                        
-                        // Display consequence
-                        _consequenceText.setString(selectedChoice.consequence);
-                        _showConsequence = true;
-                        _consequenceTimer = 3.0f;
-                        
-                        // Consume memory
-                        if (selectedChoice.memoryCost > 0) {
-                            loseMemory(selectedChoice.memoryCost);
-                        }
-                        
-                        // Increase steps
-                        _steps++;
-                        
-                        // Lose memory each step
-                        loseMemory(1);
-                        
-                        // Increase familiarity
-                        increaseFamiliarity();
-                        
-                        // Generate new scene
-                        _scenes.push_back(generateRandomScene());
-                        
-                        // Random event
-                        std::uniform_int_distribution<int> eventDist(0, 2);
-                        if (eventDist(_rng) == 0) {
-                            triggerRandomEvent();
-                        }
+            } else if (event.key.code == sf::Keyboard::C && !_playerName.empty()) {
+                // C key: start game if name is set
+                _state = GameState::Exploring;
+                _scenes.push_back(generateRandomScene());
+            }
+        } else if (_state == GameState::Exploring) {
+            if (event.key.code >= sf::Keyboard::Num1 && 
+                event.key.code <= sf::Keyboard::Num9) {
+                int choice = event.key.code - sf::Keyboard::Num1 + 1;
+                if (!_scenes.empty() && choice > 0 && 
+                    choice <= static_cast<int>(_scenes.back().choices.size())) {
+                    Choice& selectedChoice = _scenes.back().choices[choice - 1];
+                    
+                    // Create particle effect for choice selection
+                    float choiceY = 280.0f + (choice - 1) * 35.0f;
+                    _particleSystem.createChoiceEffect(
+                        sf::Vector2f(100.0f, choiceY), 
+                        sf::Color(100, 200, 255), 
+                        15
+                    );
+                    
+                    // Display consequence
+                    _consequenceString = selectedChoice.consequence;
+                    _showConsequence = true;
+                    _consequenceTimer = 3.0f;
+                    ++_consequenceId;
+                    
+                    // Consume memory
+                    if (selectedChoice.memoryCost > 0) {
+                        loseMemory(selectedChoice.memoryCost);
+                    }
+                    
+                    // Increase steps
+                    _steps++;
+                    
+                    // Lose memory each step
+                    loseMemory(1);
+                    
+                    // Increase familiarity
+                    increaseFamiliarity();
+                    
+                    // New scene, usually prepared while the player was reading
+                    _scenes.push_back(takeNextScene());
+                    
+                    // Random event
+                    std::uniform_int_distribution<int> eventDist(0, 2);
+                    if (eventDist(_rng) == 0) {
+                        triggerRandomEvent();
                     }
-                } else if (event.key.code == sf::Keyboard::Q) {
-                    _gameRunning = false;
-                }
-            } else if (_state == GameState::GameOver) {
-                if (event.key.code == sf::Keyboard::Enter || 
-                    event.key.code == sf::Keyboard::Escape) {
-                    _gameRunning = false;
                 }
+            } else if (event.key.code == sf::Keyboard::Q) {
+                _gameRunning = false;
             }
-        }
-        
-        if (event.type == sf::Event::TextEntered && _state == GameState::WakingUp && _playerName.empty()) {
-            if (event.text.unicode < 128) {
-                if (event.text.unicode == '\b' && !_currentInput.empty()) {
-                    _currentInput.pop_back();
-                } else if (event.text.unicode != '\r' && event.text.unicode != '\n') {
-                    _currentInput += static_cast<char>(event.text.unicode);
-                }
+        } else if (_state == GameState::GameOver) {
+            if (event.key.code == sf::Keyboard::Enter || 
+                event.key.code == sf::Keyboard::Escape) {
+                _gameRunning = false;
             }
         }
     }
+    
+    if (event.type == sf::Event::TextEntered && _state == GameState::WakingUp && _playerName.empty()) {
+        // Input is kept as UTF-8, so any script can be typed
+        if (event.text.unicode == '\b') {
+            Utf8Text::popBack(_currentInput);
+        } else if (event.text.unicode >= ' ' && event.text.unicode != 127) {
+            Utf8Text::append(_currentInput, event.text.unicode);
+        }
+    }
 }
 
 void StoryGame::update() {
     // Check game over condition
     if (_memoryPoints <= 0 && _state == GameState::Exploring) {
         _state = GameState::GameOver;
+        _uiDirty = true;
         // Create dramatic particle effect when game ends (one time)
         if (!_gameOverParticlesCreated) {
             for (int i = 0; i < 10; ++i) {
@@ -326,38 +642,107 @@ void StoryGame::update() {
     if (_familiarity >= 50 && _state == GameState::Exploring) {
         // Can add special story here
     }
+
+    updateForceFields();
 }
 
-void StoryGame::render() {
+void StoryGame::updateForceFields() {
+    // Fields follow the layout of the last rendered frame
+    _particleSystem.clearForceFields();
+    _layouts.take();
+    const UiLayout& layout = _layouts.front();
+
+    // Lost memories swirl around the stats panel that lists them...
+    const sf::FloatRect& stats = layout.statsBox;
+    sf::Vector2f statsCenter(stats.left + stats.width * 0.5f, stats.top + stats.height * 0.5f);
+    _particleSystem.addForceField({ForceField::Type::Vortex, statsCenter, 140.0f, 320.0f});
+    _particleSystem.addForceField({ForceField::Type::Attractor, statsCenter, 60.0f, 320.0f});
+
+    // ...and shy away from the choices the player is reading
+    if (_state == GameState::Exploring && !_scenes.empty()) {
+        const std::size_t choices = std::min(_scenes.back().choices.size(), layout.choiceCount);
+        for (size_t i = 0; i < choices; ++i) {
+            _particleSystem.addForceField({ForceField::Type::Repulsor,
+                sf::Vector2f(600.0f, layout.choiceY[i] + 15.0f), 120.0f, 90.0f});
+        }
+    }
+}
+
+void StoryGame::renderFrame(const FrameSnapshot& frame) {
+    if (_uiStates.take()) {
+        applyUi(_uiStates.front());
+    }
+
+    // Text effects lay out and rasterize glyphs, so they run here, next to
+    // the draw, and follow simulated time rather than the render clock
+    const float effectStep = static_cast<float>(frame.simulatedSeconds - _effectSeconds);
+    _effectSeconds = frame.simulatedSeconds;
+    if (_useTextEffects) {
+        _mainTextEffect.update(effectStep);
+        _titleTextEffect.update(effectStep);
+    }
+    _consequenceTextEffect.update(effectStep);
+
+    const float time = _glowTimer.getElapsedTime().asSeconds();
+    _titleGlowIntensity = (std::sin(time * 2.0f) + 1.0f) * 0.5f;
+
     // ===== Background =====
-    float bgPulse = (std::sin(_glowTimer.getElapsedTime().asSeconds() * 0.5f) + 1.0f) * 0.5f;
     sf::Color bgColor = _bgColor;
-    bgColor.r = static_cast<sf::Uint8>(20 + bgPulse * 5);
-    bgColor.g = static_cast<sf::Uint8>(20 + bgPulse * 5);
-    bgColor.b = static_cast<sf::Uint8>(30 + bgPulse * 5);
-
-    _window.clear(bgColor);
-    _background.setFillColor(bgColor);
-    _window.draw(_background);
-    _particleSystem.draw(_window);
+    if (_shownState == GameState::GameOver) {
+        // Dramatic red pulse
+        float gameOverPulse = (std::sin(time * 1.5f) + 1.0f) * 0.5f;
+        bgColor.r = static_cast<sf::Uint8>(30 + gameOverPulse * 20);
+        bgColor.g = static_cast<sf::Uint8>(10 + gameOverPulse * 10);
+        bgColor.b = static_cast<sf::Uint8>(10 + gameOverPulse * 10);
+    } else {
+        float bgPulse = (std::sin(time * 0.5f) + 1.0f) * 0.5f;
+        bgColor.r = static_cast<sf::Uint8>(20 + bgPulse * 5);
+        bgColor.g = static_cast<sf::Uint8>(20 + bgPulse * 5);
+        bgColor.b = static_cast<sf::Uint8>(30 + bgPulse * 5);
+    }
 
-    float yPos = 50.0f;
+    // World layer, possibly at a lower resolution; the UI below stays sharp
+    sf::RenderTarget& world = beginWorld(bgColor);
+    _particleSystem.drawBatch(world, frame.particles);
+    presentWorld();
 
-    // ===== Title Box =====
-    // Use base colors, not current colors
-    sf::Color titleBoxBaseColor(30, 30, 45, 200);
-    titleBoxBaseColor.a = static_cast<sf::Uint8>(200 + _titleGlowIntensity * 55);
-    _titleBox.setFillColor(titleBoxBaseColor);
+    // ===== Chrome =====
+    // Boxes only move when the text they frame changes size, so the
+    // geometry is rebuilt then; glows below only touch group colors
+    float yPos = 140.0f;
+    float statsHeight = std::max(50.0f, std::min(100.0f, _statsText.getTextHeight() + 20.0f));
+    float textTop = yPos + statsHeight + 5.0f;
+    bool showTextBox = false;
+    bool layoutChanged = placeBox(_statsBox, 50.0f, yPos, 1100.0f, statsHeight);
+    if (_shownState == GameState::GameOver) {
+        layoutChanged |= placeBox(_textBox, 50.0f, 100.0f, 1100.0f, 600.0f);
+    } else if (_shownState == GameState::WakingUp) {
+        showTextBox = true;
+        layoutChanged |= placeBox(_textBox, 50.0f, textTop, 1100.0f,
+                                  std::max(350.0f, _mainText.getTextHeight() + 50.0f));
+    } else if (_shownState == GameState::Exploring && _shownScene) {
+        showTextBox = true;
+        layoutChanged |= placeBox(_textBox, 50.0f, textTop, 1100.0f, _mainText.getTextHeight() + 40.0f);
+    }
+    if (layoutChanged || _chromeState != _shownState || _chromeShowsTextBox != showTextBox ||
+        _chrome.getRebuildCount() == 0) {
+        rebuildChrome(showTextBox);
+    }
+    updateChromeColors(time);
+    _window.draw(_chrome);
 
-    sf::Color titleOutlineBaseColor(120, 180, 255, 150);
-    titleOutlineBaseColor.a = static_cast<sf::Uint8>(150 + _titleGlowIntensity * 105);
-    _titleBox.setOutlineColor(titleOutlineBaseColor);
+    UiLayout& layout = _layouts.back();
+    layout.statsBox = _statsBox.getGlobalBounds();
+    layout.choiceCount = 0;
 
-    _window.draw(_titleBox);
+    if (_shownState == GameState::GameOver) {
+        _layouts.publish();
+        renderGameOver(time);
+        return;
+    }
 
     // ===== Title Text (STABLE COLOR) =====
-    _titleText.setString("                  Memory Labyrinth");
-    _titleText.setPosition(70.0f, yPos + 15.0f);
+    _titleText.setPosition(70.0f, 65.0f);
 
     {
         sf::Color base = _titleBaseColor;
@@ -372,59 +757,24 @@ void StoryGame::render() {
         _window.draw(_titleText);
     }
 
-    yPos += 90.0f;
-
     // ===== Stats =====
-    displayStats();
-    float statsHeight = std::max(50.0f, std::min(100.0f, _statsText.getGlobalBounds().height + 20.0f));
-    _statsBox.setSize({1100, statsHeight});
-    _window.draw(_statsBox);
-
     _statsText.setFillColor(_statsBaseColor);
     _statsText.setPosition(70.0f, yPos + 10.0f);
     _window.draw(_statsText);
-    yPos += statsHeight + 5.0f;
+    yPos = textTop;
 
     // ===== Waking Up =====
-    if (_state == GameState::WakingUp) {
-        std::string wakeText =
-            "You slowly open your eyes...\n\n"
-            "The cold ground presses against your cheek.\n\n"
-            "Please enter your name:\n\n";
-
-        wakeText += _playerName.empty()
-            ? "> " + _currentInput + "_"
-            : "Your name appears on the wall: " + _playerName + "\n\nPress ENTER to begin...\n";
-
-        _mainText.setString(wakeText);
-        float textHeight = _mainText.getLocalBounds().height + 50.0f;
-        float textBoxHeight = std::max(350.0f, textHeight);
-
-        // Use base color, not current color (avoid color accumulation)
-        sf::Color boxBaseColor(15, 15, 25, 220);
-        _textBox.setFillColor(boxBaseColor);
-        _textBox.setSize({1100, textBoxHeight});
-        _textBox.setPosition(50.0f, yPos);
-        _window.draw(_textBox);
-
+    if (_shownState == GameState::WakingUp) {
         _mainText.setFillColor(_mainBaseColor);
         _mainText.setPosition(70.0f, yPos + 20.0f);
         _window.draw(_mainText);
     }
 
     // ===== Exploring =====
-    else if (_state == GameState::Exploring && !_scenes.empty()) {
-        Scene& scene = _scenes.back();
+    else if (_shownState == GameState::Exploring && _shownScene) {
         float sceneY = yPos;
 
-        std::string sceneText = scene.description + "\n\n";
-        _mainText.setString(sceneText);
-
-        float sceneTextHeight = _mainText.getGlobalBounds().height;
-        _textBox.setSize({1100, sceneTextHeight + 40.0f});
-        _textBox.setPosition(50.0f, sceneY);
-        _window.draw(_textBox);
-
+        float sceneTextHeight = _mainText.getTextHeight();
         _mainText.setFillColor(_mainBaseColor);
         _mainText.setPosition(70.0f, sceneY + 20.0f);
         _window.draw(_mainText);
@@ -432,12 +782,8 @@ void StoryGame::render() {
         sceneY += sceneTextHeight + 60.0f;
 
         // ===== Choices =====
-        for (size_t i = 0; i < scene.choices.size(); ++i) {
-            _choiceTexts[i].setString(
-                "[" + std::to_string(i + 1) + "] " + scene.choices[i].text
-            );
-
-            float pulse = (std::sin(_glowTimer.getElapsedTime().asSeconds() * 2.0f + i) + 1.0f) * 0.5f;
+        for (size_t i = 0; i < _shownChoices; ++i) {
+            float pulse = (std::sin(time * 2.0f + i) + 1.0f) * 0.5f;
             sf::Color base = _choiceBaseColor;
             float glow = 0.9f + pulse * 0.1f;
 
@@ -451,79 +797,259 @@ void StoryGame::render() {
             _choiceTexts[i].setFillColor(drawColor);
             _choiceTexts[i].setPosition(85.0f, sceneY);
             _window.draw(_choiceTexts[i]);
+            layout.choiceY[layout.choiceCount++] = sceneY;
 
-            sceneY += 38.0f;
+            // Wrapped choices take as many lines as they need
+            sceneY += std::max(38.0f, _choiceTexts[i].getTextHeight() + 8.0f);
         }
 
         // ===== Consequence =====
-        if (_showConsequence) {
-            sf::Color base = _consequenceBaseColor;
-            float pulse = (std::sin(_glowTimer.getElapsedTime().asSeconds() * 4.0f) + 1.0f) * 0.5f;
-            float glow = 0.8f + pulse * 0.2f;
+        // The effect's Glow pass pulses it; only the fade-out is applied here
+        if (frame.showConsequence) {
+            sf::Color drawColor = _consequenceBaseColor;
+            drawColor.a = static_cast<sf::Uint8>(frame.consequenceFade * 255.0f);
+            if (drawColor != _consequenceTextEffect.getFillColor()) {
+                _consequenceTextEffect.setFillColor(drawColor);
+            }
+            _consequenceTextEffect.setPosition(sf::Vector2f(70.0f, sceneY + 10.0f));
+            _consequenceTextEffect.draw(_window);
+        }
+    }
 
-            sf::Color drawColor(
-                static_cast<sf::Uint8>(base.r * glow),
-                static_cast<sf::Uint8>(base.g * glow),
-                static_cast<sf::Uint8>(base.b * glow),
-                static_cast<sf::Uint8>(std::min(255.0f, (_consequenceTimer / 3.0f) * 255.0f))
-            );
+    _layouts.publish();
+}
+
+void StoryGame::setRenderScale(float scale, bool smooth) {
+    _renderScale = std::max(0.1f, std::min(1.0f, scale));
+    _renderSmooth = smooth;
+    _usePixelEffect = _renderScale < 1.0f;
+    if (!_usePixelEffect) return;
 
-            _consequenceText.setFillColor(drawColor);
-            _consequenceText.setPosition(70.0f, sceneY + 10.0f);
-            _window.draw(_consequenceText);
+    const sf::Vector2u windowSize = _window.getSize();
+    const sf::Vector2u textureSize = _pixelRenderTexture.getSize();
+    if (textureSize.x != windowSize.x || textureSize.y != windowSize.y) {
+        if (!_pixelRenderTexture.create(windowSize.x, windowSize.y)) {
+            // No render texture support: keep drawing at full resolution
+            _usePixelEffect = false;
+            _renderScale = 1.0f;
+            return;
         }
     }
+    _pixelRenderTexture.setSmooth(smooth);
 
-    else if (_state == GameState::GameOver) {
-        // Create dramatic background effect
-        float gameOverPulse = (std::sin(_glowTimer.getElapsedTime().asSeconds() * 1.5f) + 1.0f) * 0.5f;
-        sf::Color gameOverBg(30, 10, 10);
-        gameOverBg.r = static_cast<sf::Uint8>(30 + gameOverPulse * 20);
-        gameOverBg.g = static_cast<sf::Uint8>(10 + gameOverPulse * 10);
-        gameOverBg.b = static_cast<sf::Uint8>(10 + gameOverPulse * 10);
-        _window.clear(gameOverBg);
-        _background.setFillColor(gameOverBg);
-        _window.draw(_background);
-        
-        // Draw particles (memory loss effect)
-        _particleSystem.draw(_window);
-        
-        // Main game over box with animated glow
-        float boxGlow = (std::sin(_glowTimer.getElapsedTime().asSeconds() * 2.0f) + 1.0f) * 0.5f;
+    // The world keeps its 1200x800 coordinates; it just lands on fewer pixels
+    const unsigned int width = std::max(1u, static_cast<unsigned int>(windowSize.x * _renderScale + 0.5f));
+    const unsigned int height = std::max(1u, static_cast<unsigned int>(windowSize.y * _renderScale + 0.5f));
+    sf::View view(sf::FloatRect(0.0f, 0.0f, static_cast<float>(windowSize.x), static_cast<float>(windowSize.y)));
+    view.setViewport(sf::FloatRect(0.0f, 0.0f,
+        static_cast<float>(width) / windowSize.x, static_cast<float>(height) / windowSize.y));
+    _pixelRenderTexture.setView(view);
+    // Covers the whole view, which lands exactly on the scaled viewport
+    _pixelClear.setSize(sf::Vector2f(static_cast<float>(windowSize.x), static_cast<float>(windowSize.y)));
+    _pixelClearAll = true;
+
+    _pixelSprite.setTexture(_pixelRenderTexture.getTexture());
+    _pixelSprite.setTextureRect(sf::IntRect(0, 0, static_cast<int>(width), static_cast<int>(height)));
+    _pixelSprite.setScale(static_cast<float>(windowSize.x) / width, static_cast<float>(windowSize.y) / height);
+}
+
+void StoryGame::setDynamicResolution(bool enabled) {
+    _dynamicResolution = enabled;
+    if (!enabled) {
+        _resolutionGovernor = FrameGovernor();
+        _resolutionGovernor.setMinScale(0.5f);
+        setRenderScale(1.0f, _renderSmooth);
+    }
+}
+
+sf::RenderTarget& StoryGame::beginWorld(const sf::Color& clearColor) {
+    if (!_usePixelEffect) {
+        _window.clear(clearColor);
+        return _window;
+    }
+    // clear() would wipe the whole full-size texture; only the scaled
+    // viewport gets drawn and upscaled, so just overwrite that. After a
+    // scale change the rest is cleared once, so smooth upscaling never
+    // filters in what an older, larger frame left past the viewport edge.
+    if (_pixelClearAll) {
+        _pixelRenderTexture.clear(clearColor);
+        _pixelClearAll = false;
+        return _pixelRenderTexture;
+    }
+    _pixelClear.setFillColor(clearColor);
+    _pixelRenderTexture.draw(_pixelClear, sf::BlendNone);
+    return _pixelRenderTexture;
+}
+
+void StoryGame::presentWorld() {
+    if (!_usePixelEffect) return;
+    _pixelRenderTexture.display();
+    // Opaque, so no blending needed
+    _window.draw(_pixelSprite, sf::BlendNone);
+}
+
+bool StoryGame::placeBox(sf::RectangleShape& box, float x, float y, float width, float height) {
+    if (box.getPosition() == sf::Vector2f(x, y) && box.getSize() == sf::Vector2f(width, height)) {
+        return false;
+    }
+    box.setPosition(x, y);
+    box.setSize({width, height});
+    return true;
+}
+
+void StoryGame::rebuildChrome(bool showTextBox) {
+    _chrome.clear();
+
+    if (_shownState == GameState::GameOver) {
+        // Main box: a 4px frame, plus 2px more that fades in with the glow
+        sf::FloatRect box(_textBox.getPosition(), _textBox.getSize());
+        _chrome.addRect(box, ChromeTextFill);
+        _chrome.addFrame(box, 4.0f, ChromeTextOutline);
+        _chrome.addFrame(sf::FloatRect(box.left - 4.0f, box.top - 4.0f, box.width + 8.0f, box.height + 8.0f),
+                         2.0f, ChromeTextGlow);
+
+        sf::FloatRect statsBox(70.0f, 460.0f, 1050.0f, 120.0f);
+        _chrome.addRect(statsBox, ChromeEndStatsFill);
+        _chrome.addFrame(statsBox, 2.0f, ChromeEndStatsOutline);
+
+        // Corner decorations: an 80px line each way from every corner
+        const sf::Vector2f corners[] = {{50.0f, 100.0f}, {1150.0f, 100.0f}, {50.0f, 700.0f}, {1150.0f, 700.0f}};
+        for (const sf::Vector2f& corner : corners) {
+            _chrome.addRect(sf::FloatRect(corner.x, corner.y, 80.0f, 2.0f), ChromeCorners);
+            _chrome.addRect(sf::FloatRect(corner.x - 2.0f, corner.y, 2.0f, 80.0f), ChromeCorners);
+        }
+    } else {
+        _chrome.addShape(_titleBox, ChromeTitleFill, ChromeTitleOutline);
+        _chrome.addShape(_statsBox, ChromeStatsFill, ChromeStatsOutline);
+        if (showTextBox) {
+            _chrome.addShape(_textBox, ChromeTextFill, ChromeTextOutline);
+        }
+    }
+
+    _chrome.commit();
+    _chromeState = _shownState;
+    _chromeShowsTextBox = showTextBox;
+}
+
+void StoryGame::updateChromeColors(float time) {
+    if (_shownState == GameState::GameOver) {
+        float boxGlow = (std::sin(time * 2.0f) + 1.0f) * 0.5f;
         sf::Color boxColor(50, 15, 15);
         boxColor.a = static_cast<sf::Uint8>(220 + boxGlow * 35);
-        _textBox.setFillColor(boxColor);
-        
+        _chrome.setGroupColor(ChromeTextFill, boxColor);
+
         sf::Color outlineColor(220, 60, 60);
         outlineColor.a = static_cast<sf::Uint8>(180 + boxGlow * 75);
-        _textBox.setOutlineColor(outlineColor);
-        _textBox.setOutlineThickness(4.0f + boxGlow * 2.0f);
-        _textBox.setSize(sf::Vector2f(1100, 600));
-        _textBox.setPosition(50.0f, 100.0f);
-        _window.draw(_textBox);
-        
-        float gameOverY = 120.0f;
-        
-        // Game Over Title with dramatic effect
-        float titlePulse = (std::sin(_glowTimer.getElapsedTime().asSeconds() * 3.0f) + 1.0f) * 0.5f;
-        sf::Text gameOverTitle;
-        gameOverTitle.setFont(_font);
-        gameOverTitle.setString(
-                               "                         GAME OVER\n"
-                               );
-        gameOverTitle.setCharacterSize(42);
-        gameOverTitle.setStyle(sf::Text::Bold);
-        sf::Color titleColor(255, 100, 100);
-        titleColor.r = static_cast<sf::Uint8>(200 + titlePulse * 55);
-        titleColor.g = static_cast<sf::Uint8>(80 + titlePulse * 20);
-        titleColor.b = static_cast<sf::Uint8>(80 + titlePulse * 20);
-        gameOverTitle.setFillColor(titleColor);
-        gameOverTitle.setPosition(70.0f, gameOverY);
-        _window.draw(gameOverTitle);
-        gameOverY += 120.0f;
-        
-        // Main narrative text with fade effect
-        std::string narrativeText = 
+        _chrome.setGroupColor(ChromeTextOutline, outlineColor);
+        outlineColor.a = static_cast<sf::Uint8>(outlineColor.a * boxGlow);
+        _chrome.setGroupColor(ChromeTextGlow, outlineColor);
+
+        float statsGlow = (std::sin(time * 1.8f) + 1.0f) * 0.5f;
+        sf::Color statsBoxColor(40, 25, 25);
+        statsBoxColor.a = static_cast<sf::Uint8>(180 + statsGlow * 40);
+        _chrome.setGroupColor(ChromeEndStatsFill, statsBoxColor);
+        sf::Color statsOutlineColor(150, 100, 100);
+        statsOutlineColor.a = static_cast<sf::Uint8>(120 + statsGlow * 60);
+        _chrome.setGroupColor(ChromeEndStatsOutline, statsOutlineColor);
+
+        float cornerGlow = (std::sin(time * 1.0f) + 1.0f) * 0.5f;
+        sf::Color cornerColor(200, 80, 80);
+        cornerColor.a = static_cast<sf::Uint8>(100 + cornerGlow * 80);
+        _chrome.setGroupColor(ChromeCorners, cornerColor);
+        return;
+    }
+
+    // Title box breathes with the title glow; the other boxes keep their colors
+    sf::Color titleBoxBaseColor = _titleBox.getFillColor();
+    titleBoxBaseColor.a = static_cast<sf::Uint8>(200 + _titleGlowIntensity * 55);
+    _chrome.setGroupColor(ChromeTitleFill, titleBoxBaseColor);
+
+    sf::Color titleOutlineBaseColor = _titleBox.getOutlineColor();
+    titleOutlineBaseColor.a = static_cast<sf::Uint8>(150 + _titleGlowIntensity * 105);
+    _chrome.setGroupColor(ChromeTitleOutline, titleOutlineBaseColor);
+
+    _chrome.setGroupColor(ChromeStatsFill, _statsBox.getFillColor());
+    _chrome.setGroupColor(ChromeStatsOutline, _statsBox.getOutlineColor());
+    _chrome.setGroupColor(ChromeTextFill, _textBox.getFillColor());
+    _chrome.setGroupColor(ChromeTextOutline, _textBox.getOutlineColor());
+}
+
+void StoryGame::renderGameOver(float time) {
+    float gameOverY = 120.0f;
+    
+    // Game Over Title with dramatic effect
+    float titlePulse = (std::sin(time * 3.0f) + 1.0f) * 0.5f;
+    sf::Color titleColor(255, 100, 100);
+    titleColor.r = static_cast<sf::Uint8>(200 + titlePulse * 55);
+    titleColor.g = static_cast<sf::Uint8>(80 + titlePulse * 20);
+    titleColor.b = static_cast<sf::Uint8>(80 + titlePulse * 20);
+    _gameOverTitle.setFillColor(titleColor);
+    _gameOverTitle.setPosition(70.0f, gameOverY);
+    _window.draw(_gameOverTitle);
+    gameOverY += 120.0f;
+    
+    // Main narrative text with fade effect
+    sf::Color narrativeColor(240, 200, 200);
+    float narrativeGlow = 0.85f + (std::sin(time * 1.2f) + 1.0f) * 0.15f;
+    narrativeColor.r = static_cast<sf::Uint8>(narrativeColor.r * narrativeGlow);
+    narrativeColor.g = static_cast<sf::Uint8>(narrativeColor.g * narrativeGlow);
+    narrativeColor.b = static_cast<sf::Uint8>(narrativeColor.b * narrativeGlow);
+    _mainText.setFillColor(narrativeColor);
+    _mainText.setPosition(70.0f, gameOverY);
+    _window.draw(_mainText);
+    gameOverY += 220.0f;
+    
+    // Statistics text
+    _gameOverStats.setPosition(90.0f, gameOverY + 15.0f);
+    _window.draw(_gameOverStats);
+    gameOverY += 140.0f;
+    
+    // Exit prompt with blinking effect
+    float blinkSpeed = 2.5f;
+    float blink = (std::sin(time * blinkSpeed) + 1.0f) * 0.5f;
+    sf::Color promptColor(255, 180, 120);
+    promptColor.a = static_cast<sf::Uint8>(150 + blink * 105);
+    _exitPrompt.setFillColor(promptColor);
+    _exitPrompt.setPosition(70.0f, gameOverY);
+    _window.draw(_exitPrompt);
+}
+
+void StoryGame::displayScene() {
+    // This method is now handled directly in render()
+}
+
+void StoryGame::publishUi() {
+    // Copies every string that depends on game state. Runs only on frames
+    // with input or a state change; the render thread then lays out just
+    // the strings that came out different, so idle frames do no text
+    // layout at all.
+    UiState& ui = _uiStates.back();
+    ui.state = _state;
+    ui.hasScene = !_scenes.empty();
+    ui.choiceCount = 0;
+    ui.consequenceText = _consequenceString;
+    ui.consequenceId = _consequenceId;
+    ui.statsText = describeStats();
+
+    if (_state == GameState::WakingUp) {
+        ui.mainText =
+            "You slowly open your eyes...\n\n"
+            "The cold ground presses against your cheek.\n\n"
+            "Please enter your name:\n\n";
+
+        ui.mainText += _playerName.empty()
+            ? "> " + _currentInput + "_"
+            : "Your name appears on the wall: " + _playerName + "\n\nPress ENTER to begin...\n";
+    } else if (_state == GameState::Exploring && !_scenes.empty()) {
+        const Scene& scene = _scenes.back();
+        ui.mainText = scene.description;
+
+        ui.choiceCount = std::min<std::size_t>(scene.choices.size(), 9);
+        for (size_t i = 0; i < ui.choiceCount; ++i) {
+            ui.choiceTexts[i] = "[" + std::to_string(i + 1) + "] " + scene.choices[i].text;
+        }
+    } else if (_state == GameState::GameOver) {
+        ui.mainText =
             "All your memories have faded away...\n\n"
             "You stand in the center of the street,\n"
             "not knowing who you are,\n"
@@ -531,129 +1057,41 @@ void StoryGame::render() {
             "But this street...\n"
             "You remember it.\n"
             "You've been here before...\n";
-        
-        _mainText.setString(narrativeText);
-        _mainText.setCharacterSize(24);
-        sf::Color narrativeColor(240, 200, 200);
-        float narrativeGlow = 0.85f + (std::sin(_glowTimer.getElapsedTime().asSeconds() * 1.2f) + 1.0f) * 0.15f;
-        narrativeColor.r = static_cast<sf::Uint8>(narrativeColor.r * narrativeGlow);
-        narrativeColor.g = static_cast<sf::Uint8>(narrativeColor.g * narrativeGlow);
-        narrativeColor.b = static_cast<sf::Uint8>(narrativeColor.b * narrativeGlow);
-        _mainText.setFillColor(narrativeColor);
-        _mainText.setPosition(70.0f, gameOverY);
-        _window.draw(_mainText);
-        gameOverY += 220.0f;
-        
-        // Statistics box with glow
-        sf::RectangleShape statsBox;
-        statsBox.setSize(sf::Vector2f(1050, 120));
-        float statsGlow = (std::sin(_glowTimer.getElapsedTime().asSeconds() * 1.8f) + 1.0f) * 0.5f;
-        sf::Color statsBoxColor(40, 25, 25);
-        statsBoxColor.a = static_cast<sf::Uint8>(180 + statsGlow * 40);
-        statsBox.setFillColor(statsBoxColor);
-        sf::Color statsOutlineColor(150, 100, 100);
-        statsOutlineColor.a = static_cast<sf::Uint8>(120 + statsGlow * 60);
-        statsBox.setOutlineColor(statsOutlineColor);
-        statsBox.setOutlineThickness(2.0f);
-        statsBox.setPosition(70.0f, gameOverY);
-        _window.draw(statsBox);
-        
-        // Statistics text
-        std::string statsText = 
+
+        ui.gameOverStats =
             "                                        Final Statistics:\n"
             "                                            Steps Taken: " + std::to_string(_steps) + "\n"
             "                                            Street Familiarity: " + std::to_string(_familiarity) + "%\n"
             "                                            Memories Lost: " + std::to_string(_lostMemories.size());
-        
-        sf::Text statsDisplay;
-        statsDisplay.setFont(_font);
-        statsDisplay.setString(statsText);
-        statsDisplay.setCharacterSize(22);
-        statsDisplay.setFillColor(sf::Color(255, 220, 180));
-        statsDisplay.setPosition(90.0f, gameOverY + 15.0f);
-        _window.draw(statsDisplay);
-        gameOverY += 140.0f;
-        
-        // Exit prompt with blinking effect
-        float blinkSpeed = 2.5f;
-        float blink = (std::sin(_glowTimer.getElapsedTime().asSeconds() * blinkSpeed) + 1.0f) * 0.5f;
-        sf::Text exitPrompt;
-        exitPrompt.setFont(_font);
-        exitPrompt.setString(">>> Press ENTER or ESC to exit <<<");
-        exitPrompt.setCharacterSize(20);
-        exitPrompt.setStyle(sf::Text::Bold);
-        sf::Color promptColor(255, 180, 120);
-        promptColor.a = static_cast<sf::Uint8>(150 + blink * 105);
-        exitPrompt.setFillColor(promptColor);
-        exitPrompt.setPosition(70.0f, gameOverY);
-        _window.draw(exitPrompt);
-        
-        // Add corner decorations (simple lines)
-        float cornerGlow = (std::sin(_glowTimer.getElapsedTime().asSeconds() * 1.0f) + 1.0f) * 0.5f;
-        sf::Color cornerColor(200, 80, 80);
-        cornerColor.a = static_cast<sf::Uint8>(100 + cornerGlow * 80);
-        
-        // Top-left corner
-        sf::RectangleShape corner1(sf::Vector2f(80.0f, 2.0f));
-        corner1.setFillColor(cornerColor);
-        corner1.setPosition(50.0f, 100.0f);
-        corner1.setRotation(0.0f);
-        _window.draw(corner1);
-        
-        sf::RectangleShape corner2(sf::Vector2f(80.0f, 2.0f));
-        corner2.setFillColor(cornerColor);
-        corner2.setPosition(50.0f, 100.0f);
-        corner2.setRotation(90.0f);
-        _window.draw(corner2);
-        
-        // Top-right corner
-        sf::RectangleShape corner3(sf::Vector2f(80.0f, 2.0f));
-        corner3.setFillColor(cornerColor);
-        corner3.setPosition(1150.0f, 100.0f);
-        corner3.setRotation(0.0f);
-        _window.draw(corner3);
-        
-        sf::RectangleShape corner4(sf::Vector2f(80.0f, 2.0f));
-        corner4.setFillColor(cornerColor);
-        corner4.setPosition(1150.0f, 100.0f);
-        corner4.setRotation(90.0f);
-        _window.draw(corner4);
-        
-        // Bottom-left corner
-        sf::RectangleShape corner5(sf::Vector2f(80.0f, 2.0f));
-        corner5.setFillColor(cornerColor);
-        corner5.setPosition(50.0f, 700.0f);
-        corner5.setRotation(0.0f);
-        _window.draw(corner5);
-        
-        sf::RectangleShape corner6(sf::Vector2f(80.0f, 2.0f));
-        corner6.setFillColor(cornerColor);
-        corner6.setPosition(50.0f, 700.0f);
-        corner6.setRotation(90.0f);
-        _window.draw(corner6);
-        
-        // Bottom-right corner
-        sf::RectangleShape corner7(sf::Vector2f(80.0f, 2.0f));
-        corner7.setFillColor(cornerColor);
-        corner7.setPosition(1150.0f, 700.0f);
-        corner7.setRotation(0.0f);
-        _window.draw(corner7);
-        
-        sf::RectangleShape corner8(sf::Vector2f(80.0f, 2.0f));
-        corner8.setFillColor(cornerColor);
-        corner8.setPosition(1150.0f, 700.0f);
-        corner8.setRotation(90.0f);
-        _window.draw(corner8);
     }
 
-    _window.display();
+    _uiStates.publish();
 }
 
-void StoryGame::displayScene() {
-    // This method is now handled directly in render()
+void StoryGame::applyUi(const UiState& ui) {
+    // UiText skips strings that came out the same
+    _shownState = ui.state;
+    _shownScene = ui.hasScene;
+    _shownChoices = ui.choiceCount;
+    if (ui.consequenceId != _shownConsequenceId) {
+        // A new consequence plays from the start, even if the text repeats
+        _shownConsequenceId = ui.consequenceId;
+        _consequenceTextEffect.setString(ui.consequenceText);
+        _consequenceTextEffect.start();
+    }
+    _statsText.setString(ui.statsText);
+    _statsText.setLineSpacing(1.2f);
+    _mainText.setString(ui.mainText);
+    for (std::size_t i = 0; i < ui.choiceCount; ++i) {
+        _choiceTexts[i].setString(ui.choiceTexts[i]);
+    }
+    if (ui.state == GameState::GameOver) {
+        _mainText.setCharacterSize(24);
+        _gameOverStats.setString(ui.gameOverStats);
+    }
 }
 
-void StoryGame::displayStats() {
+std::string StoryGame::describeStats() const {
     std::string stats = "Steps: " + std::to_string(_steps) + "  |  ";
     stats += "Memory: " + std::to_string(_memoryPoints) + "/10  |  ";
     stats += "Familiarity: " + std::to_string(_familiarity) + "%";
@@ -671,8 +1109,7 @@ void StoryGame::displayStats() {
         }
     }
     
-    _statsText.setString(stats);
-    _statsText.setLineSpacing(1.2f);
+    return stats;
 }
 
 void StoryGame::loseMemory(int amount) {
@@ -684,6 +1121,7 @@ void StoryGame::loseMemory(int amount) {
     if (_memoryPoints <= 0 && !_memories.empty()) {
         // Lose the last memory
         _lostMemories.push_back(_memories.back());
+        ++_lostMemoriesVersion;
         _memories.pop_back();
         _particleSystem.createMemoryLossEffect(sf::Vector2f(600.0f, 300.0f), 40);
     } else if (!_memories.empty()) {
@@ -693,6 +1131,7 @@ void StoryGame::loseMemory(int amount) {
             std::uniform_int_distribution<size_t> dist(0, _memories.size() - 1);
             size_t index = dist(_rng);
             _lostMemories.push_back(_memories[index]);
+            ++_lostMemoriesVersion;
             _memories.erase(_memories.begin() + index);
         }
     }
@@ -718,53 +1157,99 @@ void StoryGame::gainMemory(const Memory& memory) {
 
 void StoryGame::increaseFamiliarity() {
     std::uniform_int_distribution<int> incDist(1, 3);
-    _familiarity = std::min(100, _familiarity + incDist(_rng));
+    const int familiarity = std::min(100, _familiarity + incDist(_rng));
+    if (familiarity != _familiarity) {
+        _familiarity = familiarity;
+        ++_familiarityVersion;
+    }
 }
 
 void StoryGame::triggerRandomEvent() {
-    std::vector<std::string> events = {
-        "You hear footsteps in the distance, but when you turn around, there's nothing.",
-        "A cold wind blows past, you feel someone watching you.",
-        "You see new writing appear on the wall, but when you approach, it disappears.",
-        "You feel someone calling your name, but the voice comes from all directions.",
-        "You see your shadow moving on the wall, but you haven't moved.",
-        "You hear someone crying, but can't find the source of the sound.",
-        "You feel this street changing, but can't say what's different."
-    };
-    
-    std::uniform_int_distribution<size_t> dist(0, events.size() - 1);
-    std::string eventText = "[Event] " + events[dist(_rng)];
-    _consequenceText.setString(eventText);
+    std::uniform_int_distribution<size_t> dist(0, _eventTexts.size() - 1);
+    std::string eventText = "[Event] " + _eventTexts[dist(_rng)];
+    _consequenceString = eventText;
     _showConsequence = true;
     _consequenceTimer = 3.0f;
+    ++_consequenceId;
+}
+
+void StoryGame::pregenerateScene() {
+    if (_state != GameState::Exploring || _hasNextScene) return;
+
+    _nextSceneStreet = rollScene(_nextScene);
+    fitScene(_nextScene, _nextSceneStreet);
+    _nextSceneFamiliarityVersion = _familiarityVersion;
+    _nextSceneLostMemoriesVersion = _lostMemoriesVersion;
+    _hasNextScene = true;
+}
+
+Scene StoryGame::takeNextScene() {
+    if (!_hasNextScene) return generateRandomScene();
+    _hasNextScene = false;
+
+    // The choice that led here usually changed familiarity or lost a
+    // memory; the rolled street and choices still hold, but the parts
+    // that follow the game state are fitted again, right now
+    if (_nextSceneFamiliarityVersion != _familiarityVersion ||
+        _nextSceneLostMemoriesVersion != _lostMemoriesVersion) {
+        fitScene(_nextScene, _nextSceneStreet);
+    }
+    return std::move(_nextScene);
+}
+
+void StoryGame::printJobStats() {
+    std::vector<JobSystem::WorkerStats> stats = _jobs.sampleStats();
+
+    std::ostringstream line;
+    line << std::fixed << std::setprecision(0) << "jobs:";
+    for (std::size_t i = 0; i < stats.size(); ++i) {
+        line << (i == 0 ? " main " : " | w" + std::to_string(i) + " ")
+             << stats[i].utilization * 100.0 << "% (" << stats[i].jobs << " jobs";
+        if (stats[i].steals > 0) {
+            line << ", " << stats[i].steals << " stolen";
+        }
+        line << ")";
+    }
+
+    // Last frame, node by node
+    line << std::setprecision(2) << "\nframe:";
+    for (TaskGraph::NodeId node = 0; node < _frameGraph.getNodeCount(); ++node) {
+        line << " " << _frameGraph.getName(node) << " " << _frameGraph.getLastSeconds(node) * 1000.0 << "ms";
+    }
+    std::cout << line.str() << std::endl;
+}
+
+void StoryGame::printFontStats() {
+    // Glyph pages only exist for the sizes drawn so far (the pre-warmed ones)
+    std::ostringstream report;
+    report << std::fixed << std::setprecision(1);
+    for (const FontRegistry::FontUsage& usage : FontRegistry::instance().report()) {
+        report << "font: " << usage.path << "  file " << usage.sourceBytes / 1024.0 << " KiB"
+               << ", glyph pages " << usage.textureBytes / 1024.0 << " KiB, sizes";
+        for (unsigned int size : usage.characterSizes) {
+            report << " " << size;
+        }
+        report << ", " << usage.handles << " handles\n";
+    }
+    report << "fonts total " << FontRegistry::instance().getMemoryUsage() / 1024.0 << " KiB"
+           << ", baked atlas " << GlyphAtlas::instance().getMemoryUsage() / 1024.0 << " KiB";
+    std::cout << report.str() << std::endl;
 }
 
 Scene StoryGame::generateRandomScene() {
     Scene scene;
-    
+    fitScene(scene, rollScene(scene));
+    return scene;
+}
+
+std::string StoryGame::rollScene(Scene& scene) {
     // Generate street description
     std::uniform_int_distribution<size_t> descDist(0, _streetDescriptions.size() - 1);
-    scene.description = _streetDescriptions[descDist(_rng)];
-    
-    // Adjust description based on familiarity
-    if (_familiarity > 30) {
-        scene.description += " This street feels unsettlingly familiar.";
-    }
-    if (_familiarity > 60) {
-        scene.description += " You begin to remember some details...";
-    }
+    const std::string street = _streetDescriptions[descDist(_rng)];
     
     // Generate choices
-    std::vector<std::pair<std::string, std::string>> choiceTemplates = {
-        {"Continue forward", "You take a step, the path beneath your feet seems more familiar"},
-        {"Turn left", "You turn left, a strange feeling washes over you"},
-        {"Turn right", "You turn right, you feel you've walked this path before"},
-        {"Stop and observe", "You stop and carefully observe your surroundings"},
-        {"Check the wall", "You approach the wall and find some blurry writing on it"},
-        {"Look back", "You look back, but the path you came from has become unfamiliar"},
-        {"Quickly walk", "You quicken your pace, wanting to escape this place"},
-        {"Walk slowly", "You slow down, trying to remember every detail"}
-    };
+    scene.choices.clear();
+    std::vector<std::pair<std::string, std::string>> choiceTemplates = _choiceTemplates;
     
     std::uniform_int_distribution<int> choiceNumDist(2, 4);
     int numChoices = choiceNumDist(_rng);  // 2-4 choices
@@ -783,10 +1268,22 @@ Scene StoryGame::generateRandomScene() {
     std::uniform_int_distribution<int> memoryDist(0, 3);
     scene.hasMemory = (memoryDist(_rng) == 0);  // 25% chance
     scene.memoryGained = false;
+    
+    return street;
+}
+
+void StoryGame::fitScene(Scene& scene, const std::string& street) {
+    // Adjust description based on familiarity
+    scene.description = street;
+    if (_familiarity > 30) {
+        scene.description += " This street feels unsettlingly familiar.";
+    }
+    if (_familiarity > 60) {
+        scene.description += " You begin to remember some details...";
+    }
+    
     if (scene.hasMemory && !_lostMemories.empty()) {
         std::uniform_int_distribution<size_t> memDist(0, _lostMemories.size() - 1);
         scene.memory = _lostMemories[memDist(_rng)];
     }
-    
-    return scene;
 }
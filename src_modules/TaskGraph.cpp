@@ -0,0 +1,54 @@
+#include "TaskGraph.hpp"
+#include <chrono>
+
+TaskGraph::NodeId TaskGraph::add(const std::string& name, std::function<void()> work) {
+    Node node;
+    node.name = name;
+    node.work = std::move(work);
+    _nodes.push_back(std::move(node));
+    return _nodes.size() - 1;
+}
+
+void TaskGraph::precede(NodeId before, NodeId after) {
+    _nodes[before].successors.push_back(after);
+    ++_nodes[after].dependencies;
+}
+
+void TaskGraph::run(JobSystem& jobs) {
+    if (_nodes.empty()) return;
+
+    if (_remaining.size() != _nodes.size()) {
+        _remaining = std::vector<std::atomic<unsigned int>>(_nodes.size());
+    }
+    for (NodeId node = 0; node < _nodes.size(); ++node) {
+        _remaining[node].store(_nodes[node].dependencies, std::memory_order_relaxed);
+    }
+
+    // Every node finishes exactly once, so the whole graph is one counter
+    _jobs = &jobs;
+    _pending.store(_nodes.size(), std::memory_order_relaxed);
+    for (NodeId node = 0; node < _nodes.size(); ++node) {
+        if (_nodes[node].dependencies == 0) {
+            jobs.submit(&TaskGraph::runNode, this, node, 1, _pending);
+        }
+    }
+    jobs.wait(_pending);
+    _jobs = nullptr;
+}
+
+void TaskGraph::runNode(const void* context, std::size_t index) {
+    // The graph is only const to fit the job signature; run() owns it meanwhile
+    TaskGraph& graph = *const_cast<TaskGraph*>(static_cast<const TaskGraph*>(context));
+    Node& node = graph._nodes[index];
+
+    const auto start = std::chrono::steady_clock::now();
+    node.work();
+    node.lastSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    // The last dependency to finish releases a successor
+    for (NodeId successor : node.successors) {
+        if (graph._remaining[successor].fetch_sub(1, std::memory_order_acq_rel) == 1) {
+            graph._jobs->submit(&TaskGraph::runNode, context, successor, 1, graph._pending);
+        }
+    }
+}
@@ -1,117 +1,162 @@
 #include "TextEffect.hpp"
+#include "Utf8Text.hpp"
+#include "GlyphAtlas.hpp"
+#include "TextLayout.hpp"
 #include <cmath>
 #include <algorithm>
+#include <climits>
+#include <utility>
+
+namespace {
+    // Glyph sources for layoutGlyphs: FreeType through sf::Font, or the atlas
+    struct FontGlyphs {
+        const sf::Font& font;
+        unsigned int characterSize;
+
+        const sf::Glyph& glyph(sf::Uint32 c) const { return font.getGlyph(c, characterSize, false); }
+        float kerning(sf::Uint32 first, sf::Uint32 second) const { return font.getKerning(first, second, characterSize); }
+        float lineSpacing() const { return font.getLineSpacing(characterSize); }
+    };
+
+    struct BakedGlyphs {
+        const BakedFace& face;
+
+        const sf::Glyph& glyph(sf::Uint32 c) const { return face.getGlyph(c); }
+        float kerning(sf::Uint32 first, sf::Uint32 second) const { return face.getKerning(first, second); }
+        float lineSpacing() const { return face.getLineSpacing(); }
+    };
+}
 
 TextEffect::TextEffect()
-    : _effectType(EffectType::None)
+    : _characterSize(30)
+    , _wrapWidth(0.0f)
+    , _baseColor(255, 255, 255, 255)
+    , _glyphs(sf::Triangles)
+    , _bakedFace(nullptr)
+    , _layoutDirty(true)
+    , _animatesGlyphs(false)
     , _timer(0.0f)
     , _currentCharIndex(0)
+    , _revealProgress(0.0f)
+    , _fadeAlpha(1.0f)
+    , _brightness(1.0f)
     , _isActive(false)
     , _isComplete(false)
     , _typewriterSpeed(30.0f)  // 30 characters per second
     , _fadeSpeed(2.0f)
     , _glowIntensity(1.0f)
     , _shakeIntensity(0.0f)
-    , _shakeOffset(0.0f, 0.0f)
-    , _baseColor(255, 255, 255, 255)
 {
+    _glyphVertexEnd.push_back(0);
+    setChain<>();
 }
 
 void TextEffect::setText(const std::string& text, EffectType type) {
     _fullText = text;
-    _displayText = "";
-    _effectType = type;
-    _currentCharIndex = 0;
-    _timer = 0.0f;
-    _isComplete = false;
-    
-    if (type == EffectType::None || type == EffectType::FadeIn) {
-        _displayText = text;
+    _layoutDirty = true;
+
+    // The only switch on the enum: it picks a chain once, not every frame
+    switch (type) {
+        case EffectType::Typewriter: setChain<Typewriter>(); break;
+        case EffectType::FadeIn:     setChain<FadeIn>(); break;
+        case EffectType::Glow:       setChain<Glow>(); break;
+        case EffectType::Shake:      setChain<Shake>(); break;
+        case EffectType::Wave:       setChain<Wave>(); break;
+        case EffectType::Dissolve:   setChain<Dissolve>(); break;
+        default:                     setChain<>(); break;
     }
 }
 
-void TextEffect::setFont(const sf::Font& font) {
-    _font = font;
-    _text.setFont(_font);
+void TextEffect::setString(const std::string& text) {
+    _fullText = text;
+    _layoutDirty = true;
+}
+
+void TextEffect::setFont(FontHandle font) {
+    FontChain fonts;
+    fonts.add(std::move(font));
+    setFonts(fonts);
+}
+
+void TextEffect::setFonts(const FontChain& fonts) {
+    _fonts = fonts;
+    _layoutDirty = true;
 }
 
 void TextEffect::setCharacterSize(unsigned int size) {
-    _text.setCharacterSize(size);
+    _characterSize = size;
+    _layoutDirty = true;
 }
 
 void TextEffect::setFillColor(const sf::Color& color) {
     _baseColor = color;  // Save base color
-    _text.setFillColor(color);
+    for (std::size_t i = 0; i < _glyphs.getVertexCount(); ++i) {
+        _glyphs[i].color = color;
+    }
+    if (!_layoutDirty) {
+        applyGlyphTransforms();
+    }
 }
 
 void TextEffect::setPosition(const sf::Vector2f& position) {
     _basePosition = position;
-    _text.setPosition(position);
+}
+
+void TextEffect::setWrapWidth(float width) {
+    if (_wrapWidth == width) return;
+    _wrapWidth = width;
+    _layoutDirty = true;
 }
 
 void TextEffect::update(float deltaTime) {
-    if (!_isActive || _isComplete) return;
-    
+    if (!_isActive) return;
+    if (_layoutDirty) buildLayout();
+
     _timer += deltaTime;
-    
-    switch (_effectType) {
-        case EffectType::Typewriter:
-            updateTypewriter(deltaTime);
-            break;
-        case EffectType::FadeIn:
-            updateFadeIn(deltaTime);
-            break;
-        case EffectType::Glow:
-            updateGlow(deltaTime);
-            break;
-        case EffectType::Shake:
-            updateShake(deltaTime);
-            break;
-        case EffectType::Wave:
-            updateWave(deltaTime);
-            break;
-        default:
-            _isComplete = true;
-            break;
+    _isComplete = _chainUpdate(*this, deltaTime);
+
+    // Nothing left to animate once a finite, purely revealing chain is done
+    if (_isComplete && !_animatesGlyphs) {
+        _isActive = false;
     }
 }
 
 void TextEffect::draw(sf::RenderWindow& window) {
-    if (_displayText.empty()) return;
-    
-    // Apply shake offset if active
-    if (_effectType == EffectType::Shake && _shakeIntensity > 0.0f) {
-        _text.setPosition(_basePosition + _shakeOffset);
+    if (_layoutDirty) buildLayout();
+
+    const int totalChars = static_cast<int>(_glyphVertexEnd.size()) - 1;
+    const std::size_t vertexCount = _glyphVertexEnd[std::min(_currentCharIndex, totalChars)];
+    if (vertexCount == 0) return;
+
+    if (_animatesGlyphs) {
+        drawGlyphs(window, _animated.data(), vertexCount);
     } else {
-        _text.setPosition(_basePosition);
+        drawGlyphs(window, &_glyphs[0], vertexCount);
     }
-    
-    window.draw(_text);
 }
 
 void TextEffect::start() {
     _isActive = true;
-    _isComplete = false;
-    _timer = 0.0f;
-    _currentCharIndex = 0;
-    
-    if (_effectType == EffectType::Typewriter) {
-        _displayText = "";
-    } else if (_effectType == EffectType::FadeIn) {
-        _displayText = _fullText;
-        sf::Color color = _text.getFillColor();
-        color.a = 0;
-        _text.setFillColor(color);
-    }
+    restart();
 }
 
 void TextEffect::reset() {
     _isActive = false;
+    restart();
+}
+
+void TextEffect::restart() {
     _isComplete = false;
     _timer = 0.0f;
-    _currentCharIndex = 0;
-    _displayText = "";
-    _shakeOffset = sf::Vector2f(0.0f, 0.0f);
+    _currentCharIndex = INT_MAX;  // Everything visible unless the chain reveals
+    _fadeAlpha = 1.0f;
+    _brightness = 1.0f;
+    _chainStart(*this);
+
+    if (!_layoutDirty) {
+        beginGlyphFrame();
+        applyGlyphTransforms();
+    }
 }
 
 bool TextEffect::isComplete() const {
@@ -135,80 +180,232 @@ void TextEffect::setShakeIntensity(float intensity) {
 }
 
 std::string TextEffect::getCurrentText() const {
-    return _displayText;
+    std::size_t count = static_cast<std::size_t>(std::max(0, _currentCharIndex));
+    return _fullText.substr(0, Utf8Text::prefixBytes(_fullText, count));
 }
 
 sf::FloatRect TextEffect::getGlobalBounds() const {
-    return _text.getGlobalBounds();
+    sf::FloatRect bounds = _glyphs.getBounds();
+    bounds.left += _basePosition.x;
+    bounds.top += _basePosition.y;
+    return bounds;
 }
 
 sf::Color TextEffect::getFillColor() const {
-    return _text.getFillColor();
+    return _baseColor;
 }
 
-void TextEffect::updateTypewriter(float deltaTime) {
-    float charsToAdd = _typewriterSpeed * deltaTime;
-    int totalChars = static_cast<int>(_fullText.length());
-    
-    while (charsToAdd >= 1.0f && _currentCharIndex < totalChars) {
-        _displayText += _fullText[_currentCharIndex];
-        _currentCharIndex++;
-        charsToAdd -= 1.0f;
-    }
-    
-    // Handle partial characters for smooth animation
-    if (_currentCharIndex < totalChars && charsToAdd > 0.0f) {
-        float progress = (_currentCharIndex + charsToAdd) / totalChars;
-        if (progress >= 1.0f || _currentCharIndex >= totalChars - 1) {
-            _displayText = _fullText;
-            _currentCharIndex = totalChars;
+void TextEffect::buildLayout() {
+    _layoutDirty = false;
+    _glyphs.clear();
+    _glyphVertexEnd.assign(1, 0);
+    _glyphCenterX.clear();
+    _glyphCenterY.clear();
+
+    const sf::String text = Utf8Text::decode(_fullText);
+    _font = _fonts.select(text);
+
+    // Prefer the prebuilt atlas when it was baked from this font and has
+    // every character; only then does layout skip FreeType entirely
+    const GlyphAtlas& atlas = GlyphAtlas::instance();
+    const FontHandle& primary = _fonts.primary();
+    _bakedFace = nullptr;
+    if (atlas.isLoaded() && primary && atlas.isBakedFrom(*primary)) {
+        const BakedFace* face = atlas.findFace(_characterSize, false);
+        if (face && face->covers(text)) {
+            _bakedFace = face;
         }
     }
-    
-    _text.setString(_displayText);
-    
-    if (_currentCharIndex >= totalChars) {
-        _isComplete = true;
+
+    if (_bakedFace) {
+        const sf::String lines = _wrapWidth > 0.0f
+            ? TextLayoutCache::instance().wrap(_fullText, *_bakedFace, _wrapWidth).text : text;
+        layoutGlyphs(lines, BakedGlyphs{*_bakedFace});
+    } else if (_font) {
+        FontRegistry::instance().noteCharacterSize(*_font, _characterSize);
+        const sf::String lines = _wrapWidth > 0.0f
+            ? TextLayoutCache::instance().wrap(_fullText, *_font, _characterSize, _wrapWidth).text : text;
+        layoutGlyphs(lines, FontGlyphs{*_font, _characterSize});
+    } else {
+        _glyphVertexEnd.resize(text.getSize() + 1, 0);
+        beginGlyphFrame();
+        applyGlyphTransforms();
+        return;
     }
+
+    // Seeds depend only on the glyph index, so a text dissolves the same way every time
+    const std::size_t glyphCount = _glyphCenterX.size();
+    _glyphSeed.resize(glyphCount);
+    FastRandom seeds(0x5EEDull + glyphCount);
+    for (std::size_t g = 0; g < glyphCount; ++g) {
+        _glyphSeed[g] = seeds.nextFloat();
+    }
+
+    beginGlyphFrame();
+    applyGlyphTransforms();
+}
+
+template <typename Glyphs>
+void TextEffect::layoutGlyphs(const sf::String& text, const Glyphs& glyphs) {
+    // Same rules as sf::Text for the regular style: kerning, whitespace
+    // advances, one quad with a 1px padding per visible glyph
+    const unsigned int size = _characterSize;
+    const float whitespaceWidth = glyphs.glyph(L' ').advance;
+    const float lineSpacing = glyphs.lineSpacing();
+    const float padding = 1.0f;
+
+    float x = 0.0f;
+    float y = static_cast<float>(size);
+    sf::Uint32 previous = 0;
+    _glyphVertexEnd.reserve(text.getSize() + 1);
+
+    for (std::size_t i = 0; i < text.getSize(); ++i) {
+        sf::Uint32 current = text[i];
+        if (current != L'\r') {
+            x += glyphs.kerning(previous, current);
+            previous = current;
+        }
+
+        if (current == L' ' || current == L'\t' || current == L'\n' || current == L'\r') {
+            if (current == L' ') x += whitespaceWidth;
+            else if (current == L'\t') x += whitespaceWidth * 4.0f;
+            else if (current == L'\n') { y += lineSpacing; x = 0.0f; }
+            _glyphVertexEnd.push_back(_glyphs.getVertexCount());
+            continue;
+        }
+
+        const sf::Glyph& glyph = glyphs.glyph(current);
+        float left = x + glyph.bounds.left - padding;
+        float top = y + glyph.bounds.top - padding;
+        float right = x + glyph.bounds.left + glyph.bounds.width + padding;
+        float bottom = y + glyph.bounds.top + glyph.bounds.height + padding;
+
+        float u1 = static_cast<float>(glyph.textureRect.left) - padding;
+        float v1 = static_cast<float>(glyph.textureRect.top) - padding;
+        float u2 = static_cast<float>(glyph.textureRect.left + glyph.textureRect.width) + padding;
+        float v2 = static_cast<float>(glyph.textureRect.top + glyph.textureRect.height) + padding;
+
+        _glyphs.append(sf::Vertex(sf::Vector2f(left, top), _baseColor, sf::Vector2f(u1, v1)));
+        _glyphs.append(sf::Vertex(sf::Vector2f(right, top), _baseColor, sf::Vector2f(u2, v1)));
+        _glyphs.append(sf::Vertex(sf::Vector2f(left, bottom), _baseColor, sf::Vector2f(u1, v2)));
+        _glyphs.append(sf::Vertex(sf::Vector2f(left, bottom), _baseColor, sf::Vector2f(u1, v2)));
+        _glyphs.append(sf::Vertex(sf::Vector2f(right, top), _baseColor, sf::Vector2f(u2, v1)));
+        _glyphs.append(sf::Vertex(sf::Vector2f(right, bottom), _baseColor, sf::Vector2f(u2, v2)));
+
+        _glyphCenterX.push_back((left + right) * 0.5f);
+        _glyphCenterY.push_back((top + bottom) * 0.5f);
+
+        x += glyph.advance;
+        _glyphVertexEnd.push_back(_glyphs.getVertexCount());
+    }
+}
+
+void TextEffect::beginGlyphFrame() {
+    // Passes accumulate into these, so every frame starts from rest
+    const std::size_t glyphCount = _glyphCenterX.size();
+    _glyphOffsetX.assign(glyphCount, 0.0f);
+    _glyphOffsetY.assign(glyphCount, 0.0f);
+    _glyphAngle.assign(glyphCount, 0.0f);
+    _glyphAlpha.assign(glyphCount, 1.0f);
+    _brightness = 1.0f;
 }
 
-void TextEffect::updateFadeIn(float deltaTime) {
-    sf::Color color = _text.getFillColor();
-    color.a = std::min(255, static_cast<int>(color.a + _fadeSpeed * 255.0f * deltaTime));
-    _text.setFillColor(color);
-    
-    if (color.a >= 255) {
-        _isComplete = true;
+void TextEffect::applyGlyphTransforms() {
+    const std::size_t glyphCount = _glyphCenterX.size();
+    _animated.resize(glyphCount * 6);
+
+    // Use base color, not current color (avoid color accumulation)
+    const sf::Color tint(
+        static_cast<sf::Uint8>(std::min(255.0f, _baseColor.r * _brightness)),
+        static_cast<sf::Uint8>(std::min(255.0f, _baseColor.g * _brightness)),
+        static_cast<sf::Uint8>(std::min(255.0f, _baseColor.b * _brightness)));
+    const float baseAlpha = static_cast<float>(_baseColor.a) * _fadeAlpha;
+
+    // Rotate each quad about its own center, then offset it
+    const SinCosTable& table = SinCosTable::instance();
+    for (std::size_t g = 0; g < glyphCount; ++g) {
+        float s, c;
+        table.sinCos(_glyphAngle[g], s, c);
+        const float cx = _glyphCenterX[g];
+        const float cy = _glyphCenterY[g];
+        const float ox = cx + _glyphOffsetX[g];
+        const float oy = cy + _glyphOffsetY[g];
+        const sf::Color color(tint.r, tint.g, tint.b, static_cast<sf::Uint8>(_glyphAlpha[g] * baseAlpha));
+
+        const sf::Vertex* source = &_glyphs[g * 6];
+        sf::Vertex* target = &_animated[g * 6];
+        for (int v = 0; v < 6; ++v) {
+            float dx = source[v].position.x - cx;
+            float dy = source[v].position.y - cy;
+            target[v].position = sf::Vector2f(ox + dx * c - dy * s, oy + dx * s + dy * c);
+            target[v].texCoords = source[v].texCoords;
+            target[v].color = color;
+        }
     }
 }
 
+void TextEffect::drawGlyphs(sf::RenderWindow& window, const sf::Vertex* vertices, std::size_t vertexCount) {
+    if (vertexCount == 0 || (!_font && !_bakedFace)) return;
+
+    // Fetch the page after layout: getGlyph may have grown it
+    sf::RenderStates states(_bakedFace ? &GlyphAtlas::instance().getTexture() : &_font->getTexture(_characterSize));
+    states.transform.translate(_basePosition);
+    window.draw(vertices, vertexCount, sf::Triangles, states);
+}
+
+bool TextEffect::updateTypewriter(float deltaTime) {
+    // The whole text is already laid out; revealing only moves the end of
+    // the drawn vertex range, so each frame is O(1) however long the text is
+    int totalChars = static_cast<int>(_glyphVertexEnd.size()) - 1;
+    _revealProgress += _typewriterSpeed * deltaTime;
+    _currentCharIndex = std::min(totalChars, static_cast<int>(_revealProgress));
+    return _currentCharIndex >= totalChars;
+}
+
+bool TextEffect::updateFadeIn(float deltaTime) {
+    _fadeAlpha = std::min(1.0f, _fadeAlpha + _fadeSpeed * deltaTime);
+    return _fadeAlpha >= 1.0f;
+}
+
 void TextEffect::updateGlow(float deltaTime) {
     float glow = (std::sin(_timer * 3.0f) + 1.0f) * 0.5f; // 0 to 1
-    
-    // Use base color, not current color (avoid color accumulation)
-    float brightness = 0.7f + glow * 0.3f * _glowIntensity;
-    sf::Color color(
-        std::min(255, static_cast<int>(_baseColor.r * brightness)),
-        std::min(255, static_cast<int>(_baseColor.g * brightness)),
-        std::min(255, static_cast<int>(_baseColor.b * brightness)),
-        _baseColor.a
-    );
-    
-    _text.setFillColor(color);
+    _brightness *= 0.7f + glow * 0.3f * _glowIntensity;
 }
 
 void TextEffect::updateShake(float deltaTime) {
-    if (_shakeIntensity > 0.0f) {
-        float shakeX = (std::rand() % 200 - 100) / 100.0f * _shakeIntensity;
-        float shakeY = (std::rand() % 200 - 100) / 100.0f * _shakeIntensity;
-        _shakeOffset = sf::Vector2f(shakeX, shakeY);
+    // Every glyph jitters on its own, with a slight wobble
+    const std::size_t glyphCount = _glyphCenterX.size();
+    for (std::size_t g = 0; g < glyphCount; ++g) {
+        _glyphOffsetX[g] += _random.range(-1.0f, 1.0f) * _shakeIntensity;
+        _glyphOffsetY[g] += _random.range(-1.0f, 1.0f) * _shakeIntensity;
+        _glyphAngle[g] += _random.range(-0.01f, 0.01f) * _shakeIntensity;
     }
 }
 
 void TextEffect::updateWave(float deltaTime) {
-    // Wave effect would require per-character positioning
-    // For now, we'll use a simple vertical wave
-    float wave = std::sin(_timer * 2.0f) * 5.0f;
-    _text.setPosition(_basePosition + sf::Vector2f(0.0f, wave));
+    // A sine wave travelling along the line, phase taken from each glyph's x
+    const SinCosTable& table = SinCosTable::instance();
+    const float phase = _timer * 0.35f;
+    const std::size_t glyphCount = _glyphCenterX.size();
+    for (std::size_t g = 0; g < glyphCount; ++g) {
+        float s, c;
+        table.sinCos(phase - _glyphCenterX[g] * 0.004f, s, c);
+        _glyphOffsetY[g] += s * 5.0f;
+        _glyphAngle[g] += c * 0.01f;
+    }
 }
 
+bool TextEffect::updateDissolve(float deltaTime) {
+    // Glyphs let go in random order: each starts fading once the progress
+    // passes its seed, drifting up and turning as it goes
+    const float progress = _timer * _fadeSpeed * 0.25f;
+    const std::size_t glyphCount = _glyphCenterX.size();
+    for (std::size_t g = 0; g < glyphCount; ++g) {
+        float gone = std::min(1.0f, std::max(0.0f, (progress - _glyphSeed[g] * 0.75f) * 4.0f));
+        _glyphAlpha[g] *= 1.0f - gone;
+        _glyphOffsetY[g] -= gone * 24.0f;
+        _glyphOffsetX[g] += (_glyphSeed[g] - 0.5f) * gone * 16.0f;
+        _glyphAngle[g] += (_glyphSeed[g] - 0.5f) * gone * 0.25f;
+    }
+    return progress >= 1.0f;
+}
@@ -0,0 +1,201 @@
+#include "TextLayout.hpp"
+#include "Utf8Text.hpp"
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+
+namespace {
+    // CJK ideographs, kana, Hangul and fullwidth forms may break anywhere
+    bool breaksAnywhere(sf::Uint32 c) {
+        return (c >= 0x2E80 && c <= 0x9FFF) || (c >= 0xAC00 && c <= 0xD7AF) ||
+               (c >= 0xF900 && c <= 0xFAFF) || (c >= 0xFF00 && c <= 0xFFEF);
+    }
+
+    // What wrapping needs from a font, read from FreeType or from the atlas
+    struct FontMetrics {
+        const sf::Font& font;
+        unsigned int characterSize;
+        bool bold;
+
+        float advance(sf::Uint32 c) const { return font.getGlyph(c, characterSize, bold).advance; }
+        float kerning(sf::Uint32 first, sf::Uint32 second) const { return font.getKerning(first, second, characterSize); }
+        float lineSpacing() const { return font.getLineSpacing(characterSize); }
+    };
+
+    struct BakedMetrics {
+        const BakedFace& face;
+
+        float advance(sf::Uint32 c) const { return face.getGlyph(c).advance; }
+        float kerning(sf::Uint32 first, sf::Uint32 second) const { return face.getKerning(first, second); }
+        float lineSpacing() const { return face.getLineSpacing(); }
+    };
+
+    std::size_t floatBits(float value) {
+        std::uint32_t bits;
+        std::memcpy(&bits, &value, sizeof(bits));
+        return bits;
+    }
+}
+
+TextLayoutCache::TextLayoutCache(std::size_t capacity)
+    : _capacity(capacity)
+    , _hits(0)
+    , _misses(0)
+{
+}
+
+TextLayoutCache& TextLayoutCache::instance() {
+    static TextLayoutCache cache;
+    return cache;
+}
+
+std::size_t TextLayoutCache::KeyHash::operator()(const Key& key) const {
+    std::size_t h = std::hash<std::string>()(key.text);
+    auto mix = [&h](std::size_t value) { h ^= value + 0x9E3779B97F4A7C15ull + (h << 6) + (h >> 2); };
+    mix(std::hash<const void*>()(key.font));
+    mix(key.characterSize);
+    mix(floatBits(key.maxWidth));
+    mix(floatBits(key.lineSpacing));
+    mix(key.bold ? 1u : 0u);
+    return h;
+}
+
+template <typename Layout>
+const WrappedText& TextLayoutCache::find(Key key, const Layout& build) {
+    auto found = _index.find(key);
+    if (found != _index.end()) {
+        ++_hits;
+        _entries.splice(_entries.begin(), _entries, found->second);
+        return found->second->second;
+    }
+
+    ++_misses;
+    _entries.emplace_front(std::move(key), build());
+    _index.emplace(_entries.front().first, _entries.begin());
+    trim();
+    return _entries.front().second;
+}
+
+const WrappedText& TextLayoutCache::wrap(const std::string& text, const sf::Font& font, unsigned int characterSize,
+                                         float maxWidth, float lineSpacing, bool bold) {
+    return find(Key{text, &font, characterSize, maxWidth, lineSpacing, bold}, [&]() {
+        return layout(Utf8Text::decode(text), font, characterSize, maxWidth, lineSpacing, bold);
+    });
+}
+
+const WrappedText& TextLayoutCache::wrap(const std::string& text, const BakedFace& face,
+                                         float maxWidth, float lineSpacing) {
+    return find(Key{text, &face, face.getCharacterSize(), maxWidth, lineSpacing, face.isBold()}, [&]() {
+        return layout(Utf8Text::decode(text), face, maxWidth, lineSpacing);
+    });
+}
+
+void TextLayoutCache::setCapacity(std::size_t capacity) {
+    _capacity = std::max<std::size_t>(1, capacity);
+    trim();
+}
+
+void TextLayoutCache::trim() {
+    while (_entries.size() > _capacity) {
+        _index.erase(_entries.back().first);
+        _entries.pop_back();
+    }
+}
+
+namespace {
+    template <typename Metrics>
+    WrappedText wrapLines(const sf::String& text, const Metrics& metrics, float maxWidth, float lineSpacing) {
+        const float whitespaceWidth = metrics.advance(L' ');
+        const std::size_t kNoBreak = static_cast<std::size_t>(-1);
+
+        std::basic_string<sf::Uint32> out;
+        out.reserve(text.getSize() + 8);
+
+        std::size_t lineCount = 1;
+        float widest = 0.0f;
+        float lineWidth = 0.0f;
+        std::size_t breakAt = kNoBreak;   // Where the current line can be broken in out
+        bool breakIsSpace = false;        // Replace out[breakAt] rather than insert before it
+        float widthBeforeBreak = 0.0f;    // Line width up to the break
+        float widthAfterBreak = 0.0f;     // Line width after the break
+        sf::Uint32 previous = 0;
+
+        for (sf::Uint32 c : text) {
+            if (c == L'\r') continue;
+            if (c == L'\n') {
+                widest = std::max(widest, lineWidth);
+                out += c;
+                ++lineCount;
+                lineWidth = 0.0f;
+                breakAt = kNoBreak;
+                previous = 0;
+                continue;
+            }
+
+            float advance = metrics.kerning(previous, c);
+            if (c == L' ') advance += whitespaceWidth;
+            else if (c == L'\t') advance += whitespaceWidth * 4.0f;
+            else advance += metrics.advance(c);
+            previous = c;
+
+            if (c == L' ' || c == L'\t') {
+                breakAt = out.size();
+                breakIsSpace = true;
+                widthBeforeBreak = lineWidth;
+                widthAfterBreak = 0.0f;
+                out += c;
+                lineWidth += advance;
+                continue;
+            }
+
+            if (breaksAnywhere(c) && lineWidth > 0.0f) {
+                breakAt = out.size();
+                breakIsSpace = false;
+                widthBeforeBreak = lineWidth;
+                widthAfterBreak = 0.0f;
+            }
+
+            if (lineWidth + advance > maxWidth && lineWidth > 0.0f) {
+                if (breakAt != kNoBreak) {
+                    // Move everything after the last break to a new line
+                    if (breakIsSpace) {
+                        out[breakAt] = L'\n';
+                    } else {
+                        out.insert(out.begin() + breakAt, L'\n');
+                    }
+                    widest = std::max(widest, widthBeforeBreak);
+                    lineWidth = widthAfterBreak;
+                } else {
+                    // A single word wider than the line: cut it here
+                    widest = std::max(widest, lineWidth);
+                    out += L'\n';
+                    lineWidth = 0.0f;
+                }
+                ++lineCount;
+                breakAt = kNoBreak;
+            }
+
+            out += c;
+            lineWidth += advance;
+            widthAfterBreak += advance;
+        }
+        widest = std::max(widest, lineWidth);
+
+        WrappedText wrapped;
+        wrapped.text = sf::String(out);
+        wrapped.lineCount = lineCount;
+        wrapped.width = widest;
+        wrapped.height = static_cast<float>(lineCount) * metrics.lineSpacing() * lineSpacing;
+        return wrapped;
+    }
+}
+
+WrappedText TextLayoutCache::layout(const sf::String& text, const sf::Font& font, unsigned int characterSize,
+                                    float maxWidth, float lineSpacing, bool bold) {
+    return wrapLines(text, FontMetrics{font, characterSize, bold}, maxWidth, lineSpacing);
+}
+
+WrappedText TextLayoutCache::layout(const sf::String& text, const BakedFace& face, float maxWidth, float lineSpacing) {
+    return wrapLines(text, BakedMetrics{face}, maxWidth, lineSpacing);
+}
@@ -0,0 +1,117 @@
+#include "UiChrome.hpp"
+#include <algorithm>
+
+namespace {
+    // Vertex color times the color of the vertex's group (texCoords.x)
+    const char* const kVertexShader =
+        "uniform vec4 groupColors[16];\n"
+        "void main() {\n"
+        "    gl_Position = gl_ModelViewProjectionMatrix * gl_Vertex;\n"
+        "    gl_FrontColor = gl_Color * groupColors[int(gl_MultiTexCoord0.x + 0.5)];\n"
+        "}\n";
+
+    const char* const kFragmentShader =
+        "void main() {\n"
+        "    gl_FragColor = gl_Color;\n"
+        "}\n";
+}
+
+UiChrome::UiChrome()
+    : _colors(kMaxGroups, sf::Color::White)
+    , _buffer(sf::Triangles, sf::VertexBuffer::Static)
+    , _useShader(false)
+    , _useBuffer(sf::VertexBuffer::isAvailable())
+    , _colorsDirty(true)
+    , _rebuildCount(0)
+{
+    _useShader = sf::Shader::isAvailable() && _shader.loadFromMemory(kVertexShader, kFragmentShader);
+}
+
+void UiChrome::setGroupColor(std::size_t group, const sf::Color& color) {
+    if (group >= kMaxGroups || _colors[group] == color) return;
+    _colors[group] = color;
+    _colorsDirty = true;
+}
+
+void UiChrome::clear() {
+    _vertices.clear();
+}
+
+void UiChrome::addRect(const sf::FloatRect& rect, std::size_t group) {
+    if (rect.width <= 0.0f || rect.height <= 0.0f) return;
+
+    const sf::Vector2f groupCoord(static_cast<float>(std::min(group, kMaxGroups - 1)), 0.0f);
+    const float left = rect.left;
+    const float top = rect.top;
+    const float right = rect.left + rect.width;
+    const float bottom = rect.top + rect.height;
+
+    _vertices.emplace_back(sf::Vector2f(left, top), sf::Color::White, groupCoord);
+    _vertices.emplace_back(sf::Vector2f(right, top), sf::Color::White, groupCoord);
+    _vertices.emplace_back(sf::Vector2f(left, bottom), sf::Color::White, groupCoord);
+    _vertices.emplace_back(sf::Vector2f(left, bottom), sf::Color::White, groupCoord);
+    _vertices.emplace_back(sf::Vector2f(right, top), sf::Color::White, groupCoord);
+    _vertices.emplace_back(sf::Vector2f(right, bottom), sf::Color::White, groupCoord);
+}
+
+void UiChrome::addFrame(const sf::FloatRect& rect, float thickness, std::size_t group) {
+    if (thickness <= 0.0f) return;
+    const float t = thickness;
+    addRect(sf::FloatRect(rect.left - t, rect.top - t, rect.width + 2.0f * t, t), group);
+    addRect(sf::FloatRect(rect.left - t, rect.top + rect.height, rect.width + 2.0f * t, t), group);
+    addRect(sf::FloatRect(rect.left - t, rect.top, t, rect.height), group);
+    addRect(sf::FloatRect(rect.left + rect.width, rect.top, t, rect.height), group);
+}
+
+void UiChrome::addShape(const sf::RectangleShape& shape, std::size_t fillGroup, std::size_t outlineGroup) {
+    const sf::FloatRect rect(shape.getPosition(), shape.getSize());
+    addRect(rect, fillGroup);
+    addFrame(rect, shape.getOutlineThickness(), outlineGroup);
+}
+
+void UiChrome::commit() {
+    ++_rebuildCount;
+    _colorsDirty = true;
+    if (!_useBuffer) return;
+
+    if (_buffer.getVertexCount() != _vertices.size()) {
+        _buffer.create(_vertices.size());
+    }
+    if (!_vertices.empty()) {
+        _buffer.update(_vertices.data());
+    }
+}
+
+void UiChrome::applyColors() const {
+    if (!_colorsDirty) return;
+    _colorsDirty = false;
+
+    if (_useShader) {
+        std::vector<sf::Glsl::Vec4> colors(_colors.begin(), _colors.end());
+        _shader.setUniformArray("groupColors", colors.data(), colors.size());
+        return;
+    }
+
+    // No shaders: bake the group colors into the vertices
+    for (sf::Vertex& vertex : _vertices) {
+        vertex.color = _colors[static_cast<std::size_t>(vertex.texCoords.x)];
+    }
+    if (_useBuffer && !_vertices.empty()) {
+        _buffer.update(_vertices.data());
+    }
+}
+
+void UiChrome::draw(sf::RenderTarget& target, sf::RenderStates states) const {
+    if (_vertices.empty()) return;
+
+    applyColors();
+    states.texture = nullptr;
+    if (_useShader) {
+        states.shader = &_shader;
+    }
+    if (_useBuffer) {
+        target.draw(_buffer, states);
+    } else {
+        target.draw(_vertices.data(), _vertices.size(), sf::Triangles, states);
+    }
+}
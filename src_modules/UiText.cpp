@@ -0,0 +1,167 @@
+#include "UiText.hpp"
+#include "FontRegistry.hpp"
+#include "TextLayout.hpp"
+#include "Utf8Text.hpp"
+#include <algorithm>
+
+UiText::UiText()
+    : _atlasVertices(sf::Triangles)
+    , _face(nullptr)
+    , _fonts(nullptr)
+    , _wrapWidth(0.0f)
+    , _textHeight(0.0f)
+    , _lineCount(1)
+    , _boundsDirty(true)
+    , _layoutCount(0)
+{
+}
+
+void UiText::invalidate() {
+    _boundsDirty = true;
+    ++_layoutCount;
+}
+
+void UiText::setFont(const sf::Font& font) {
+    if (_text.getFont() == &font) return;
+    _text.setFont(font);
+    FontRegistry::instance().noteCharacterSize(font, _text.getCharacterSize());
+    relayout();
+}
+
+void UiText::setFonts(const FontChain& fonts) {
+    _fonts = &fonts;
+    relayout();
+}
+
+void UiText::setCharacterSize(unsigned int size) {
+    if (_text.getCharacterSize() == size) return;
+    _text.setCharacterSize(size);
+    if (_text.getFont()) {
+        FontRegistry::instance().noteCharacterSize(*_text.getFont(), size);
+    }
+    relayout();
+}
+
+void UiText::setLineSpacing(float spacing) {
+    if (_text.getLineSpacing() == spacing) return;
+    _text.setLineSpacing(spacing);
+    relayout();
+}
+
+void UiText::setStyle(sf::Uint32 style) {
+    if (_text.getStyle() == style) return;
+    _text.setStyle(style);
+    relayout();
+}
+
+void UiText::setWrapWidth(float width) {
+    if (_wrapWidth == width) return;
+    _wrapWidth = width;
+    relayout();
+}
+
+void UiText::setPosition(float x, float y) {
+    // Moving only changes the transform, the glyphs stay as they are
+    const sf::Vector2f& position = _text.getPosition();
+    if (position.x == x && position.y == y) return;
+    _text.setPosition(x, y);
+}
+
+void UiText::setFillColor(const sf::Color& color) {
+    if (_text.getFillColor() == color) return;
+    _text.setFillColor(color);
+    for (std::size_t i = 0; i < _atlasVertices.getVertexCount(); ++i) {
+        _atlasVertices[i].color = color;
+    }
+}
+
+bool UiText::setString(const std::string& text) {
+    if (text == _content) return false;
+    _content = text;
+    relayout();
+    return true;
+}
+
+const BakedFace* UiText::findBakedFace(const sf::String& text) const {
+    // The atlas only has regular and bold glyphs of the font it was baked from
+    const GlyphAtlas& atlas = GlyphAtlas::instance();
+    const sf::Uint32 style = _text.getStyle();
+    if (!atlas.isLoaded() || (style & ~static_cast<sf::Uint32>(sf::Text::Bold)) != 0) {
+        return nullptr;
+    }
+    const sf::Font* font = _fonts ? _fonts->primary().get() : _text.getFont();
+    if (!font || !atlas.isBakedFrom(*font)) {
+        return nullptr;
+    }
+    const BakedFace* face = atlas.findFace(_text.getCharacterSize(), (style & sf::Text::Bold) != 0);
+    return face && face->covers(text) ? face : nullptr;
+}
+
+void UiText::relayout() {
+    const sf::String decoded = Utf8Text::decode(_content);
+    _atlasVertices.clear();
+    _face = findBakedFace(decoded);
+    if (_face) {
+        // Drawn from the prebuilt atlas: no font selection, no FreeType
+        const float spacing = _text.getLineSpacing();
+        sf::String lines = decoded;
+        if (_wrapWidth > 0.0f) {
+            const WrappedText& wrapped = TextLayoutCache::instance().wrap(_content, *_face, _wrapWidth, spacing);
+            lines = wrapped.text;
+            _lineCount = wrapped.lineCount;
+            _textHeight = wrapped.height;
+        } else {
+            _lineCount = static_cast<std::size_t>(std::count(_content.begin(), _content.end(), '\n')) + 1;
+            _textHeight = _lineCount * _face->getLineSpacing() * spacing;
+        }
+        _atlasBounds = GlyphAtlas::appendText(*_face, lines, spacing, _text.getFillColor(), _atlasVertices);
+        _text.setString(sf::String());
+        invalidate();
+        return;
+    }
+
+    if (_fonts) {
+        const FontHandle& font = _fonts->select(decoded);
+        if (font && _text.getFont() != font.get()) {
+            _text.setFont(*font);
+            FontRegistry::instance().noteCharacterSize(*font, _text.getCharacterSize());
+        }
+    }
+
+    const sf::Font* font = _text.getFont();
+    const unsigned int size = _text.getCharacterSize();
+    if (font && _wrapWidth > 0.0f) {
+        const WrappedText& wrapped = TextLayoutCache::instance().wrap(_content, *font, size, _wrapWidth,
+            _text.getLineSpacing(), (_text.getStyle() & sf::Text::Bold) != 0);
+        _text.setString(wrapped.text);
+        _lineCount = wrapped.lineCount;
+        _textHeight = wrapped.height;
+    } else {
+        _text.setString(decoded);
+        _lineCount = static_cast<std::size_t>(std::count(_content.begin(), _content.end(), '\n')) + 1;
+        _textHeight = font ? _lineCount * font->getLineSpacing(size) * _text.getLineSpacing() : 0.0f;
+    }
+    invalidate();
+}
+
+const sf::FloatRect& UiText::getLocalBounds() const {
+    if (_boundsDirty) {
+        _bounds = _face ? _atlasBounds : _text.getLocalBounds();
+        _boundsDirty = false;
+    }
+    return _bounds;
+}
+
+sf::FloatRect UiText::getGlobalBounds() const {
+    return _text.getTransform().transformRect(getLocalBounds());
+}
+
+void UiText::draw(sf::RenderTarget& target, sf::RenderStates states) const {
+    if (_face) {
+        states.transform *= _text.getTransform();
+        states.texture = &GlyphAtlas::instance().getTexture();
+        target.draw(_atlasVertices, states);
+        return;
+    }
+    target.draw(_text, states);
+}
@@ -0,0 +1,320 @@
+// Bakes a TTF font into a GlyphAtlas: one PNG with the glyphs of every
+// requested size, plus the metrics file GlyphAtlas::loadFromFile reads.
+//
+//   FontBaker <font.ttf> <output prefix> [--text file]... <size>[b]...
+//
+// Writes <prefix>.png and <prefix>.atlas. A size suffixed with 'b' is
+// baked bold. Printable ASCII and common typographic punctuation are always
+// baked; --text adds every character of a UTF-8 file (e.g. story text).
+//
+// Glyphs are rasterized with FreeType directly rather than through sf::Font,
+// whose pages are OpenGL textures: the tool runs during the build, where
+// there may be no display to create a GL context on.
+#include "GlyphAtlas.hpp"
+#include "Utf8Text.hpp"
+#include <SFML/Graphics.hpp>
+#include <ft2build.h>
+#include FT_FREETYPE_H
+#include FT_GLYPH_H
+#include FT_OUTLINE_H
+#include FT_BITMAP_H
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <map>
+#include <set>
+#include <string>
+#include <vector>
+
+namespace {
+    const unsigned int kAtlasWidth = 1024;
+    // sf::Font's emboldening strength, in 26.6 fixed point
+    const FT_Pos kBoldWeight = 1 << 6;
+
+    struct FaceRequest {
+        unsigned int size;
+        bool bold;
+    };
+
+    // One glyph on its way from FreeType to the atlas
+    struct Placement {
+        std::size_t face;
+        sf::Uint32 codePoint;
+        sf::Glyph glyph;
+        sf::Image bitmap;     // Glyph pixels plus the 1px transparent border sf::Text samples
+    };
+
+    // A font file opened with FreeType. Loads and renders glyphs the way
+    // sf::Font does (same load flags, emboldening and metrics), so the baked
+    // atlas lays text out exactly like the font it replaces.
+    class FontFile {
+    public:
+        FontFile() = default;
+        FontFile(const FontFile&) = delete;
+        FontFile& operator=(const FontFile&) = delete;
+
+        ~FontFile() {
+            if (_face) FT_Done_Face(_face);
+            if (_library) FT_Done_FreeType(_library);
+        }
+
+        bool open(const std::string& path) {
+            if (FT_Init_FreeType(&_library) != 0) return false;
+            if (FT_New_Face(_library, path.c_str(), 0, &_face) != 0) return false;
+            return FT_Select_Charmap(_face, FT_ENCODING_UNICODE) == 0;
+        }
+
+        std::string getFamily() const { return _face->family_name ? _face->family_name : ""; }
+        bool hasGlyph(sf::Uint32 codePoint) const { return FT_Get_Char_Index(_face, codePoint) != 0; }
+
+        float getLineSpacing(unsigned int size) {
+            if (!setSize(size)) return 0.f;
+            return static_cast<float>(_face->size->metrics.height) / static_cast<float>(1 << 6);
+        }
+
+        // Fills glyph (textureRect only gets its size) and bitmap, white with
+        // the coverage as alpha
+        bool render(sf::Uint32 codePoint, unsigned int size, bool bold, sf::Glyph& glyph, sf::Image& bitmap) {
+            if (!setSize(size)) return false;
+            if (FT_Load_Char(_face, codePoint, FT_LOAD_TARGET_NORMAL | FT_LOAD_FORCE_AUTOHINT) != 0) return false;
+
+            FT_Glyph description;
+            if (FT_Get_Glyph(_face->glyph, &description) != 0) return false;
+
+            const bool outline = (description->format == FT_GLYPH_FORMAT_OUTLINE);
+            if (bold && outline) {
+                FT_Outline_Embolden(&reinterpret_cast<FT_OutlineGlyph>(description)->outline, kBoldWeight);
+            }
+            if (FT_Glyph_To_Bitmap(&description, FT_RENDER_MODE_NORMAL, nullptr, 1) != 0) {
+                FT_Done_Glyph(description);
+                return false;
+            }
+            FT_BitmapGlyph bitmapGlyph = reinterpret_cast<FT_BitmapGlyph>(description);
+            FT_Bitmap& pixels = bitmapGlyph->bitmap;
+            // Bitmap-only fonts can't be emboldened as outlines
+            if (bold && !outline) {
+                FT_Bitmap_Embolden(_library, &pixels, kBoldWeight, kBoldWeight);
+            }
+
+            glyph = sf::Glyph();
+            glyph.advance = static_cast<float>(bitmapGlyph->root.advance.x >> 16);
+            if (bold) glyph.advance += static_cast<float>(kBoldWeight) / static_cast<float>(1 << 6);
+            glyph.lsbDelta = static_cast<int>(_face->glyph->lsb_delta);
+            glyph.rsbDelta = static_cast<int>(_face->glyph->rsb_delta);
+
+            const unsigned int width = pixels.width;
+            const unsigned int height = pixels.rows;
+            if (width > 0 && height > 0) {
+                glyph.bounds = sf::FloatRect(static_cast<float>(bitmapGlyph->left), static_cast<float>(-bitmapGlyph->top),
+                                             static_cast<float>(width), static_cast<float>(height));
+                glyph.textureRect = sf::IntRect(0, 0, static_cast<int>(width), static_cast<int>(height));
+
+                bitmap.create(width + 2, height + 2, sf::Color(255, 255, 255, 0));
+                const unsigned char* row = pixels.buffer;
+                for (unsigned int y = 0; y < height; ++y, row += pixels.pitch) {
+                    for (unsigned int x = 0; x < width; ++x) {
+                        sf::Uint8 alpha;
+                        if (pixels.pixel_mode == FT_PIXEL_MODE_MONO) {
+                            alpha = (row[x / 8] & (1 << (7 - (x % 8)))) ? 255 : 0;
+                        } else {
+                            alpha = row[x];
+                        }
+                        bitmap.setPixel(x + 1, y + 1, sf::Color(255, 255, 255, alpha));
+                    }
+                }
+            }
+
+            FT_Done_Glyph(description);
+            return true;
+        }
+
+        // Same rounding as sf::Font::getKerning, including the hinting
+        // compensation of both glyphs
+        float getKerning(sf::Uint32 first, sf::Uint32 second, unsigned int size,
+                         const sf::Glyph& firstGlyph, const sf::Glyph& secondGlyph) {
+            if (first == 0 || second == 0 || !setSize(size)) return 0.f;
+
+            FT_Vector kerning;
+            kerning.x = kerning.y = 0;
+            if (FT_HAS_KERNING(_face)) {
+                FT_Get_Kerning(_face, FT_Get_Char_Index(_face, first), FT_Get_Char_Index(_face, second),
+                               FT_KERNING_UNFITTED, &kerning);
+            }
+            if (!FT_IS_SCALABLE(_face)) return static_cast<float>(kerning.x);
+
+            const float compensation = static_cast<float>(secondGlyph.lsbDelta - firstGlyph.rsbDelta);
+            return std::floor((compensation + static_cast<float>(kerning.x) + 32) / static_cast<float>(1 << 6));
+        }
+
+    private:
+        bool setSize(unsigned int size) {
+            if (_face->size && _face->size->metrics.y_ppem == size) return true;
+            return FT_Set_Pixel_Sizes(_face, 0, size) == 0;
+        }
+
+        FT_Library _library = nullptr;
+        FT_Face _face = nullptr;
+    };
+
+    void printUsage() {
+        std::cerr << "Usage: FontBaker <font.ttf> <output prefix> [--text file]... <size>[b]...\n";
+    }
+
+    bool parseFace(const std::string& arg, FaceRequest& face) {
+        char* end = nullptr;
+        long size = std::strtol(arg.c_str(), &end, 10);
+        if (size <= 0 || size > 512 || end == arg.c_str()) return false;
+        face.size = static_cast<unsigned int>(size);
+        face.bold = (*end == 'b');
+        return *end == '\0' || (face.bold && end[1] == '\0');
+    }
+}
+
+int main(int argc, char** argv) {
+    if (argc < 4) {
+        printUsage();
+        return 1;
+    }
+
+    const std::string fontPath = argv[1];
+    const std::string outputPrefix = argv[2];
+
+    // Kerning is only baked between these; text files may add thousands of
+    // CJK characters, which do not kern
+    std::set<sf::Uint32> kernedCharacters;
+    for (sf::Uint32 c = 0x20; c < 0x7F; ++c) kernedCharacters.insert(c);
+    for (sf::Uint32 c : {0x2018u, 0x2019u, 0x201Cu, 0x201Du, 0x2013u, 0x2014u, 0x2026u, 0x2022u}) {
+        kernedCharacters.insert(c);
+    }
+    std::set<sf::Uint32> characters = kernedCharacters;
+
+    std::vector<FaceRequest> requests;
+    for (int i = 3; i < argc; ++i) {
+        const std::string arg = argv[i];
+        if (arg == "--text" && i + 1 < argc) {
+            std::ifstream file(argv[++i], std::ios::binary);
+            if (!file) {
+                std::cerr << "FontBaker: cannot read " << argv[i] << "\n";
+                return 1;
+            }
+            std::string text((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+            for (sf::Uint32 c : Utf8Text::decode(text)) {
+                if (c >= 0x20) characters.insert(c);
+            }
+            continue;
+        }
+
+        FaceRequest face;
+        if (!parseFace(arg, face)) {
+            std::cerr << "FontBaker: bad size '" << arg << "'\n";
+            printUsage();
+            return 1;
+        }
+        requests.push_back(face);
+    }
+    if (requests.empty()) {
+        printUsage();
+        return 1;
+    }
+
+    FontFile font;
+    if (!font.open(fontPath)) {
+        std::cerr << "FontBaker: cannot load " << fontPath << "\n";
+        return 1;
+    }
+
+    // Rasterize everything first; every glyph keeps its own small bitmap
+    std::vector<Placement> placements;
+    std::vector<BakedFace> faces;
+    for (std::size_t f = 0; f < requests.size(); ++f) {
+        const FaceRequest& request = requests[f];
+        faces.emplace_back(request.size, request.bold, font.getLineSpacing(request.size));
+        BakedFace& face = faces.back();
+
+        // Hinting deltas of this face, for the kerning below
+        std::map<sf::Uint32, sf::Glyph> rendered;
+        for (sf::Uint32 c : characters) {
+            if (c != L' ' && !font.hasGlyph(c)) continue;
+            Placement placement;
+            placement.face = f;
+            placement.codePoint = c;
+            if (!font.render(c, request.size, request.bold, placement.glyph, placement.bitmap)) {
+                std::cerr << "FontBaker: cannot render U+" << std::hex << c << std::dec << "\n";
+                continue;
+            }
+            rendered[c] = placement.glyph;
+            placements.push_back(std::move(placement));
+        }
+        for (sf::Uint32 first : kernedCharacters) {
+            for (sf::Uint32 second : kernedCharacters) {
+                face.addKerning(first, second,
+                                font.getKerning(first, second, request.size, rendered[first], rendered[second]));
+            }
+        }
+    }
+
+    // Shelf packing, tallest first, with a 1px gap between cells
+    std::vector<std::size_t> order(placements.size());
+    for (std::size_t i = 0; i < order.size(); ++i) order[i] = i;
+    std::sort(order.begin(), order.end(), [&placements](std::size_t a, std::size_t b) {
+        return placements[a].glyph.textureRect.height > placements[b].glyph.textureRect.height;
+    });
+
+    std::vector<sf::Vector2u> positions(placements.size());
+    unsigned int x = 0;
+    unsigned int y = 0;
+    unsigned int shelfHeight = 0;
+    for (std::size_t i : order) {
+        if (placements[i].glyph.textureRect.width <= 0) continue;  // Whitespace has no bitmap
+
+        const sf::Vector2u size = placements[i].bitmap.getSize();
+        const unsigned int width = size.x + 1;
+        const unsigned int height = size.y + 1;
+        if (x + width > kAtlasWidth) {
+            x = 0;
+            y += shelfHeight;
+            shelfHeight = 0;
+        }
+        positions[i] = sf::Vector2u(x, y);
+        x += width;
+        shelfHeight = std::max(shelfHeight, height);
+    }
+    const unsigned int atlasHeight = std::max(1u, y + shelfHeight);
+
+    // Transparent white, like sf::Font's pages
+    sf::Image image;
+    image.create(kAtlasWidth, atlasHeight, sf::Color(255, 255, 255, 0));
+
+    for (std::size_t i = 0; i < placements.size(); ++i) {
+        const Placement& placement = placements[i];
+        sf::Glyph glyph = placement.glyph;
+        if (glyph.textureRect.width > 0) {
+            image.copy(placement.bitmap, positions[i].x, positions[i].y);
+            glyph.textureRect.left = static_cast<int>(positions[i].x) + 1;
+            glyph.textureRect.top = static_cast<int>(positions[i].y) + 1;
+        } else {
+            glyph.textureRect = sf::IntRect();
+        }
+        faces[placement.face].addGlyph(placement.codePoint, glyph);
+    }
+
+    GlyphAtlas atlas;
+    atlas.setFamily(font.getFamily());
+    for (BakedFace& face : faces) {
+        atlas.addFace(std::move(face));
+    }
+
+    const std::string imagePath = outputPrefix + ".png";
+    const std::string metricsPath = outputPrefix + ".atlas";
+    if (!image.saveToFile(imagePath) || !atlas.saveMetrics(metricsPath)) {
+        std::cerr << "FontBaker: cannot write " << outputPrefix << ".*\n";
+        return 1;
+    }
+
+    std::cout << "FontBaker: " << placements.size() << " glyphs in " << requests.size()
+              << " faces, " << kAtlasWidth << "x" << atlasHeight << " -> " << imagePath << "\n";
+    return 0;
+}